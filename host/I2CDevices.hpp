@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+
+#include "replay/ina226-replay.hpp"
+
+/**
+ * @class I2CDevices
+ * @brief Substitut hôte (cible IDF "linux") du composant I2CDevices, adossé à un ina226::ReplayBus.
+ *
+ * Même interface read/write que le pilote I2C réel : CTRL, Config, STATUS et INA226Manager
+ * compilent sans modification et lisent les registres rejoués.
+ */
+class I2CDevices
+{
+public:
+    explicit I2CDevices(ina226::ReplayBus &bus) : bus_(bus) {}
+
+    esp_err_t read(uint8_t reg, uint8_t *data, size_t len) { return bus_.read(reg, data, len); }
+    esp_err_t write(uint8_t reg, const uint8_t *data, size_t len) { return bus_.write(reg, data, len); }
+
+    ina226::ReplayBus &bus() { return bus_; }
+
+private:
+    ina226::ReplayBus &bus_;
+};
@@ -0,0 +1,120 @@
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "unity.h"
+
+#include "I2CDevices.hpp"
+#include "ina226.hpp"
+#include "ina226-alloc_guard.hpp"
+#include "config/ina226-config_macro.hpp"
+#include "history/ina226-history.hpp"
+#include "profile/ina226-profile.hpp"
+#include "rate/ina226-rate.hpp"
+
+/*
+ * Chaîne complète du gestionnaire sur un ReplayBus : tâches et file statiques
+ * (CONFIG_INA226_HEAP_FREE), fronts CNVR rejoués, profil et historique branchés.
+ * La tâche d'acquisition arme la garde d'allocation après l'initialisation du
+ * composant ; aucune allocation C++ ne doit suivre, quel que soit le nombre
+ * d'échantillons traités.
+ */
+
+using namespace ina226;
+
+namespace
+{
+    constexpr size_t SAMPLES = 500;
+    constexpr uint32_t SAMPLE_TIMEOUT_MS = 1000;
+
+    RawSample s_capture[SAMPLES + 1];
+    ReplayBus s_bus;
+    I2CDevices s_i2c(s_bus);
+    INA226Manager s_manager(s_i2c);
+    StaticStorage<16384, 16384, 32> s_storage;
+    LoadProfile s_profile;
+    HistoryStore s_history;
+
+    void on_edge(void *) { s_manager.notify_alert(); }
+
+    /// Attend `done()` un tick à la fois ; faux après `timeout_ms`
+    template <typename Pred>
+    bool wait_for(Pred done, uint32_t timeout_ms)
+    {
+        const TickType_t limit = pdMS_TO_TICKS(timeout_ms) + 1;
+        for (TickType_t waited = 0; !done(); ++waited)
+        {
+            if (waited >= limit)
+                return false;
+            vTaskDelay(1);
+        }
+        return true;
+    }
+
+    uint32_t published()
+    {
+        LatestSample latest;
+        return s_manager.latest(latest) ? latest.sequence : 0;
+    }
+
+    /// Rejoue l'échantillon suivant et attend sa publication par la tâche de traitement
+    bool replay_one()
+    {
+        const uint32_t expected = published() + 1;
+        return s_bus.step() && wait_for([&] { return published() >= expected; }, SAMPLE_TIMEOUT_MS);
+    }
+} // namespace
+
+void test_manager_replay_without_allocation()
+{
+    // Capture espacée de la période de conversion configurée : aucune conversion perdue attendue
+    const uint32_t period_us = RateMonitor::expected_period_us(load_config_from_kconfig());
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, period_us);
+    for (size_t i = 0; i < SAMPLES + 1; ++i)
+    {
+        s_capture[i].timestamp_us = static_cast<int64_t>(i) * period_us;
+        s_capture[i].shunt = static_cast<int16_t>(400 + i % 50);
+        s_capture[i].bus = static_cast<uint16_t>(9600 + i % 8);
+        s_capture[i].current = static_cast<int16_t>(1000 + i % 50);
+        s_capture[i].power = static_cast<uint16_t>(480 + i % 8);
+    }
+    s_bus.load(s_capture, SAMPLES + 1);
+    s_bus.set_edge_callback(on_edge, nullptr);
+
+    s_manager.attach_profile(&s_profile);
+    s_manager.attach_history(&s_history);
+    TEST_ASSERT_EQUAL(ESP_OK, s_manager.init(s_storage.threading(), s_storage.resources()));
+
+    // Garde armée par la tâche d'acquisition une fois le composant configuré
+    TEST_ASSERT_TRUE(wait_for(alloc_guard::armed, 2000));
+    const uint32_t allocations = alloc_guard::count();
+
+    for (size_t i = 0; i < SAMPLES; ++i)
+        TEST_ASSERT_TRUE_MESSAGE(replay_one(), "échantillon non publié");
+
+    TEST_ASSERT_EQUAL_UINT32(SAMPLES, published());
+    TEST_ASSERT_EQUAL_UINT32(0, alloc_guard::violations());
+    TEST_ASSERT_EQUAL_UINT32(allocations, alloc_guard::count());
+
+    RateStats rate;
+    TEST_ASSERT_TRUE(s_manager.rate_stats(rate));
+    TEST_ASSERT_EQUAL_UINT32(SAMPLES, rate.fresh);
+    TEST_ASSERT_EQUAL_UINT32(0, rate.missed);
+
+    // Latence de traitement publiée en fin de process(), après latest()
+    PipelineStats pipeline;
+    TEST_ASSERT_TRUE(wait_for([&] {
+        return s_manager.pipeline_stats(pipeline) && pipeline.processing_latency.count == SAMPLES;
+    }, SAMPLE_TIMEOUT_MS));
+    TEST_ASSERT_EQUAL_UINT32(SAMPLES, pipeline.acquisition_latency.count);
+    TEST_ASSERT_EQUAL_UINT32(0, pipeline.queue_overflows);
+
+    // Remise à zéro demandée depuis cette tâche, appliquée avant la lecture suivante
+    s_manager.reset_rate_stats();
+    TEST_ASSERT_TRUE(replay_one());
+    TEST_ASSERT_TRUE(s_manager.rate_stats(rate));
+    TEST_ASSERT_EQUAL_UINT32(1, rate.fresh);
+
+    TEST_ASSERT_EQUAL_UINT32(0, alloc_guard::violations());
+    TEST_ASSERT_EQUAL_UINT32(allocations, alloc_guard::count());
+}
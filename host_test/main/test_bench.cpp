@@ -0,0 +1,57 @@
+#include "sdkconfig.h"
+
+#if CONFIG_INA226_BENCH
+
+#include <cstdio>
+#include <cstring>
+
+#include "unity.h"
+
+#include "bench/ina226-bench.hpp"
+#include "profile/ina226-profile.hpp"
+
+/*
+ * Micro-bancs (CONFIG_INA226_BENCH) sur la cible "linux" : run() avec le bus de
+ * rejeu interne, résultats émis en JSON sur stdout pour comparer deux révisions.
+ * Vérifie que chaque cas a tourné et que les estimateurs (quantiles, ondulation)
+ * restent dans leur précision nominale.
+ */
+
+using namespace ina226;
+
+namespace
+{
+    bench::Result s_results[bench::MAX_RESULTS];
+
+    const bench::Result *find(const char *name, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            if (strcmp(s_results[i].name, name) == 0)
+                return &s_results[i];
+        return nullptr;
+    }
+} // namespace
+
+void test_bench_run()
+{
+    const size_t count = bench::run(s_results, bench::MAX_RESULTS);
+    TEST_ASSERT_TRUE(count > 0);
+    TEST_ASSERT_TRUE(count <= bench::MAX_RESULTS);
+    bench::print_json(stdout, s_results, count);
+
+    for (size_t i = 0; i < count; ++i)
+        TEST_ASSERT_TRUE_MESSAGE(s_results[i].ops > 0, s_results[i].name);
+
+    // Chemin I2CDevices de la cible linux mesuré via le rejeu interne
+    TEST_ASSERT_TRUE(find("ctrl.get_raw", count) != nullptr);
+
+    const bench::Result *p99 = find("quantile.p99", count);
+    TEST_ASSERT_TRUE(p99 != nullptr);
+    TEST_ASSERT_TRUE(p99->rel_error >= 0 && p99->rel_error <= LoadProfile::CurrentSketch::RELATIVE_ERROR);
+
+    const bench::Result *ripple = find("ripple.analyze", count);
+    TEST_ASSERT_TRUE(ripple != nullptr);
+    TEST_ASSERT_TRUE(ripple->rel_error >= 0 && ripple->rel_error < 0.1);
+}
+
+#endif // CONFIG_INA226_BENCH
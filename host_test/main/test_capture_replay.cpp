@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <cstdio>
+
+#include "unity.h"
+
+#include "I2CDevices.hpp"
+#include "capture/ina226-capture.hpp"
+#include "config/ina226-config_macro.hpp"
+#include "ctrl/ina226-ctrl.hpp"
+#include "replay/ina226-replay.hpp"
+
+/*
+ * Aller-retour d'une capture : CaptureWriter → fichier → CaptureReader (mmap) →
+ * ReplayBus::load(reader) → lecture des registres par CTRL. Les valeurs brutes, la
+ * configuration d'en-tête et les horodatages (horloge pilotée par le rejeu) doivent
+ * ressortir à l'identique, dernier bloc incomplet compris.
+ */
+
+using namespace ina226;
+
+namespace
+{
+    constexpr const char *CAPTURE_PATH = "/tmp/ina226_host_test.cap";
+    constexpr uint32_t SAMPLES_PER_BLOCK = 128;
+    constexpr size_t SAMPLES = 600; // 4 blocs pleins et un bloc partiel
+
+    RawSample s_recorded[SAMPLES];
+} // namespace
+
+void test_capture_replay_round_trip()
+{
+    const ConfigParams params = load_config_from_kconfig();
+    for (size_t i = 0; i < SAMPLES; ++i)
+    {
+        s_recorded[i].timestamp_us = 1000000 + static_cast<int64_t>(i) * 1100;
+        s_recorded[i].shunt = static_cast<int16_t>(static_cast<int>(i % 200) - 100);
+        s_recorded[i].bus = static_cast<uint16_t>(9600 + i);
+        s_recorded[i].current = static_cast<int16_t>(static_cast<int>(i % 300) - 150);
+        s_recorded[i].power = static_cast<uint16_t>(i * 7);
+    }
+
+    {
+        CaptureWriter writer(SAMPLES_PER_BLOCK);
+        TEST_ASSERT_EQUAL(ESP_OK, writer.open(CAPTURE_PATH, params, CONFIG_INA226_SHUNT_RESISTANCE_MILLIOHM));
+        for (size_t i = 0; i < SAMPLES; ++i)
+            TEST_ASSERT_EQUAL(ESP_OK, writer.append(s_recorded[i]));
+        TEST_ASSERT_EQUAL(ESP_OK, writer.close());
+    }
+
+    CaptureReader reader;
+    TEST_ASSERT_EQUAL(ESP_OK, reader.open(CAPTURE_PATH));
+    TEST_ASSERT_TRUE(reader.has_index());
+    TEST_ASSERT_EQUAL_UINT32((SAMPLES + SAMPLES_PER_BLOCK - 1) / SAMPLES_PER_BLOCK, reader.block_count());
+
+    {
+        ReplayBus bus;
+        bus.load(reader);
+        I2CDevices i2c(bus);
+        CTRL ctrl(i2c);
+
+        uint16_t config = 0;
+        TEST_ASSERT_EQUAL(ESP_OK, ctrl.read<reg::Configuration>(config));
+        TEST_ASSERT_EQUAL_UINT16(params.configuration.get_raw(), config);
+
+        for (size_t i = 0; i < SAMPLES; ++i)
+        {
+            TEST_ASSERT_TRUE(bus.step());
+            RawSample out;
+            TEST_ASSERT_EQUAL(ESP_OK, ctrl.get_raw(out));
+            TEST_ASSERT_EQUAL_INT64(s_recorded[i].timestamp_us, out.timestamp_us);
+            TEST_ASSERT_EQUAL_INT16(s_recorded[i].shunt, out.shunt);
+            TEST_ASSERT_EQUAL_UINT16(s_recorded[i].bus, out.bus);
+            TEST_ASSERT_EQUAL_INT16(s_recorded[i].current, out.current);
+            TEST_ASSERT_EQUAL_UINT16(s_recorded[i].power, out.power);
+        }
+        TEST_ASSERT_FALSE(bus.step());
+        TEST_ASSERT_EQUAL_UINT32(SAMPLES, bus.replayed());
+        TEST_ASSERT_EQUAL_UINT32(0, bus.dropped());
+    }
+
+    reader.close();
+    remove(CAPTURE_PATH);
+}
@@ -0,0 +1,22 @@
+#include <cstdlib>
+
+#include "sdkconfig.h"
+#include "unity.h"
+
+void test_capture_replay_round_trip();
+#if CONFIG_INA226_BENCH
+void test_bench_run();
+#endif
+void test_manager_replay_without_allocation();
+
+extern "C" void app_main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_capture_replay_round_trip);
+#if CONFIG_INA226_BENCH
+    RUN_TEST(test_bench_run);
+#endif
+    // En dernier : la garde armée par le gestionnaire interdit toute allocation ensuite
+    RUN_TEST(test_manager_replay_without_allocation);
+    exit(UNITY_END());
+}
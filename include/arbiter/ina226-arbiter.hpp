@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "ina226-registers.hpp"
+#include "ina226-stats.hpp"
+
+namespace ina226
+{
+    /// Classes de transactions, de la plus prioritaire à la moins prioritaire
+    enum class BusPriority : uint8_t
+    {
+        Sample,  // lectures de mesure (0x01..0x04, 0x06) : cadence d'échantillonnage
+        Control, // écritures (configuration, calibration, alertes)
+        Bulk,    // relectures de configuration, identifiants, autres périphériques
+        Count
+    };
+
+    struct BusClassStats
+    {
+        uint32_t requests = 0;
+        uint32_t contended = 0;       // bus occupé à la demande : attente
+        uint32_t timeouts = 0;
+        uint32_t deadline_misses = 0; // accordé après l'échéance indiquée
+        TimingStats wait;             // demande → attribution
+        TimingStats hold;             // attribution → libération
+    };
+
+    /**
+     * @class BusArbiter
+     * @brief Attribution d'un bus partagé transaction par transaction, par classe de priorité.
+     *
+     * Une transaction I2C ne s'interrompt pas : la « préemption » se fait entre deux
+     * transactions. À chaque libération, le bus passe au demandeur de plus haute classe,
+     * puis d'échéance la plus proche (0 : aucune), puis au plus ancien. Les lectures de
+     * mesure dépassent ainsi toute configuration ou trafic tiers en attente, et leur
+     * attente est bornée par la plus longue transaction en cours.
+     *
+     * Les autres pilotes du même bus y passent par BusArbiter::Guard ; l'INA226 via
+     * BasicInterface::set_arbiter (INA226Manager::set_bus_arbiter). Sans tas : les
+     * sémaphores des MAX_WAITERS demandeurs simultanés sont des membres.
+     */
+    class BusArbiter
+    {
+    public:
+        static constexpr size_t MAX_WAITERS = 8;
+        static constexpr size_t CLASSES = static_cast<size_t>(BusPriority::Count);
+
+        BusArbiter();
+
+        BusArbiter(const BusArbiter &) = delete;
+        BusArbiter &operator=(const BusArbiter &) = delete;
+
+        /**
+         * Attend le bus.
+         * @param deadline_us instant clock::now_us() avant lequel la transaction devrait commencer ; 0 : aucune
+         * @return ESP_ERR_TIMEOUT après `timeout`, ESP_ERR_NO_MEM si MAX_WAITERS demandeurs attendent déjà
+         */
+        esp_err_t acquire(BusPriority priority, int64_t deadline_us = 0, TickType_t timeout = portMAX_DELAY);
+        void release();
+
+        /// Bus tenu pendant la portée ; vérifier status() avant la transaction
+        class Guard
+        {
+        public:
+            Guard(BusArbiter &arbiter, BusPriority priority, int64_t deadline_us = 0,
+                  TickType_t timeout = portMAX_DELAY)
+                : arbiter_(arbiter), status_(arbiter.acquire(priority, deadline_us, timeout))
+            {
+            }
+            ~Guard()
+            {
+                if (status_ == ESP_OK)
+                    arbiter_.release();
+            }
+            Guard(const Guard &) = delete;
+            Guard &operator=(const Guard &) = delete;
+
+            esp_err_t status() const { return status_; }
+
+        private:
+            BusArbiter &arbiter_;
+            esp_err_t status_;
+        };
+
+        /// Classe d'une transaction INA226 d'après son registre
+        static constexpr BusPriority classify(uint8_t reg_addr, bool write)
+        {
+            if (write)
+                return BusPriority::Control;
+            switch (reg_addr)
+            {
+            case reg::ShuntVoltage::addr:
+            case reg::BusVoltage::addr:
+            case reg::Power::addr:
+            case reg::Current::addr:
+            case reg::MaskEnable::addr:
+                return BusPriority::Sample;
+            default:
+                return BusPriority::Bulk;
+            }
+        }
+
+        /// Copie cohérente des statistiques d'une classe
+        BusClassStats stats(BusPriority priority) const;
+        void reset_stats();
+
+        void log() const;
+        std::string to_json() const;
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 512;
+
+    private:
+        struct Waiter
+        {
+            StaticSemaphore_t sem_buf;
+            SemaphoreHandle_t sem = nullptr;
+            int64_t deadline_us = 0;
+            int64_t requested_us = 0;
+            uint32_t order = 0;
+            BusPriority priority = BusPriority::Bulk;
+            bool used = false;
+            bool granted = false;
+        };
+
+        /// Demandeur à servir en premier ; nullptr si aucun (verrou tenu)
+        Waiter *next_waiter();
+        void grant(BusPriority priority, int64_t requested_us, int64_t deadline_us, int64_t now_us);
+
+        StaticSemaphore_t lock_buf_;
+        SemaphoreHandle_t lock_;
+        Waiter waiters_[MAX_WAITERS];
+        bool busy_ = false;
+        BusPriority holder_ = BusPriority::Bulk;
+        int64_t granted_us_ = 0;
+        uint32_t order_ = 0;
+        BusClassStats stats_[CLASSES];
+    };
+
+} // namespace ina226
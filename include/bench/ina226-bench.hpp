@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "ctrl/ina226-ctrl.hpp"
+
+namespace ina226
+{
+    /**
+     * Micro-bancs d'essai (CONFIG_INA226_BENCH) des chemins chauds du composant :
+     * codage/décodage des registres, calibration, conversion d'unités, sérialisation JSON,
+     * quantiles en flux (coût par échantillon et précision face aux quantiles exacts) et
+     * FFT d'ondulation (noyau seul et chaîne complète, erreur d'amplitude).
+     * Fonctionne sur la cible et sur la cible IDF "linux" ; les allocations par opération
+     * ne sont comptées qu'avec CONFIG_INA226_ALLOC_GUARD (garde non armée).
+     */
+    namespace bench
+    {
+        struct Result
+        {
+            const char *name = nullptr;
+            uint32_t ops = 0;          // opérations mesurées
+            int64_t elapsed_us = 0;
+            double ns_per_op = 0.0;
+            double allocs_per_op = -1.0; // < 0 : non mesuré
+            double rel_error = -1.0;     // erreur relative maximale d'un estimateur ; < 0 : sans objet
+        };
+
+        /// Nombre maximal de résultats produits par run()
+        static constexpr size_t MAX_RESULTS = 48;
+
+        /**
+         * Exécute tous les bancs ; chaque cas tourne au moins `min_run_us`.
+         * @param ctrl  CTRL relié à un composant pour mesurer get()/get_raw() ; sur la cible
+         *              "linux", un bus de rejeu interne est utilisé si nullptr
+         * @return nombre de résultats écrits dans `out`
+         */
+        size_t run(Result *out, size_t max, CTRL *ctrl = nullptr, int64_t min_run_us = 20000);
+
+        /// Résultats au format JSON (une ligne), exploitable pour comparer deux révisions
+        void print_json(FILE *stream, const Result *results, size_t count);
+
+        void log(const Result *results, size_t count);
+    } // namespace bench
+
+} // namespace ina226
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "sdkconfig.h"
+
+#include "esp_err.h"
+
+#include "ina226-common_types.hpp"
+#include "config/ina226-config_types.hpp"
+#include "capture/ina226-capture_types.hpp"
+
+namespace ina226
+{
+    /**
+     * @class CaptureWriter
+     * @brief Écriture append-only d'une capture horodatée (stdio : SD/VFS sur cible, fichier sur hôte).
+     *
+     * Les échantillons sont accumulés dans un bloc en RAM (12 octets par échantillon)
+     * puis écrits d'un seul fwrite. L'index (8 octets par bloc) est écrit à la fermeture.
+     */
+    class CaptureWriter
+    {
+    public:
+        explicit CaptureWriter(uint32_t samples_per_block = 256);
+        ~CaptureWriter();
+
+        CaptureWriter(const CaptureWriter &) = delete;
+        CaptureWriter &operator=(const CaptureWriter &) = delete;
+
+        /// Crée le fichier et écrit l'en-tête à partir de la configuration courante.
+        /// `epoch_offset_us` relie les horodatages esp_timer à l'heure murale pour les requêtes hôte.
+        esp_err_t open(const char *path, const ConfigParams &params, uint16_t shunt_res_milliohm,
+                       int64_t epoch_offset_us = 0);
+
+        /// Ajoute un échantillon ; les horodatages doivent être croissants
+        esp_err_t append(const RawSample &sample);
+
+        /**
+         * Écrit le bloc en cours, même incomplet. Un échec d'écriture est mémorisé : les
+         * appels suivants le retournent et close() n'écrit ni index ni pied de fichier
+         * (le lecteur retombe sur le parcours des blocs, qui écarte le bloc tronqué).
+         */
+        esp_err_t flush();
+
+        /// Écrit le dernier bloc, l'index et le pied de fichier
+        esp_err_t close();
+
+        bool is_open() const { return file_ != nullptr; }
+        uint32_t block_count() const { return static_cast<uint32_t>(index_.size()); }
+
+    private:
+        FILE *file_ = nullptr;
+        uint32_t samples_per_block_;
+        CaptureBlockHeader block_{};
+        std::vector<CaptureRecord> records_;
+        std::vector<CaptureIndexEntry> index_;
+        int64_t last_us_ = 0;
+        esp_err_t write_error_ = ESP_OK; // premier échec d'écriture depuis open()
+
+        inline static const char *TAG = "INA226-CAPTURE";
+    };
+
+#if CONFIG_IDF_TARGET_LINUX
+    /**
+     * @class CaptureReader
+     * @brief Lecture hôte d'une capture par mmap : ouverture en O(1), recherche en O(log n).
+     *
+     * Utilise l'index de fin de fichier s'il est présent, sinon recherche directement
+     * dans les en-têtes de blocs (capture interrompue avant close()).
+     */
+    class CaptureReader
+    {
+    public:
+        CaptureReader() = default;
+        ~CaptureReader();
+
+        CaptureReader(const CaptureReader &) = delete;
+        CaptureReader &operator=(const CaptureReader &) = delete;
+
+        esp_err_t open(const char *path);
+        void close();
+
+        const CaptureFileHeader &header() const { return *header_; }
+        size_t block_count() const { return block_count_; }
+        bool has_index() const { return index_ != nullptr; }
+
+        int64_t first_time_us() const;
+        int64_t last_time_us() const;
+
+        /// Position du premier enregistrement d'horodatage >= t_us (end() si aucun)
+        CapturePosition seek(int64_t t_us) const;
+        CapturePosition end() const { return {block_count_, 0}; }
+
+        /**
+         * Copie jusqu'à `max` échantillons à partir de `pos`, avance `pos`.
+         * S'arrête avant le premier enregistrement d'horodatage >= `until_us`.
+         */
+        size_t read(CapturePosition &pos, RawSample *out, size_t max, int64_t until_us = INT64_MAX) const;
+
+        /// Échantillons de [t0_us, t1_us), jusqu'à `max`
+        size_t read_range(int64_t t0_us, int64_t t1_us, RawSample *out, size_t max) const;
+
+        /// Décodage en unités physiques avec les LSB de l'en-tête
+        void decode(const RawSample *in, size_t count, Measurement *out) const;
+
+        /// Vérifie le CRC d'un bloc
+        bool verify_block(size_t block) const;
+
+    private:
+        const uint8_t *data_ = nullptr;
+        size_t size_ = 0;
+        const CaptureFileHeader *header_ = nullptr;
+        const CaptureIndexEntry *index_ = nullptr;
+        size_t block_count_ = 0;
+
+        const CaptureBlockHeader &block(size_t k) const;
+        const CaptureRecord *records(size_t k) const;
+        /// Enregistrements exploitables d'un bloc : 0 si l'en-tête est invalide, borné au bloc
+        size_t record_count(size_t k) const;
+        int64_t block_first_us(size_t k) const;
+
+        inline static const char *TAG = "INA226-CAPTURE";
+    };
+#endif
+
+} // namespace ina226
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace ina226
+{
+    /**
+     * Format de fichier de capture (little-endian, append-only) :
+     *
+     *   CaptureFileHeader
+     *   bloc 0 : CaptureBlockHeader + samples_per_block × CaptureRecord
+     *   bloc 1 : ...
+     *   [CaptureIndexEntry × block_count + CaptureFooter]   (écrit à la fermeture)
+     *
+     * Tous les blocs ont la même taille (block_size), un bloc partiellement rempli
+     * est complété par du padding : le bloc k est donc à header_size + k × block_size,
+     * ce qui permet une recherche dichotomique même sans index (capture interrompue).
+     */
+
+    static constexpr char CAPTURE_MAGIC[8] = {'I', 'N', 'A', '2', '2', '6', 'C', 'P'};
+    static constexpr uint16_t CAPTURE_VERSION = 1;
+    static constexpr uint32_t CAPTURE_BLOCK_MAGIC = 0x304B4C42;  // "BLK0"
+    static constexpr uint32_t CAPTURE_FOOTER_MAGIC = 0x58444E49; // "INDX"
+
+    /// En-tête de fichier : métadonnées ConfigParams et échelles nécessaires au décodage
+    struct CaptureFileHeader
+    {
+        char magic[8];
+        uint16_t version;
+        uint16_t header_size;
+        uint32_t block_size;          // octets par bloc, en-tête de bloc inclus
+        uint32_t samples_per_block;
+        uint16_t config_raw;          // 0x00
+        uint16_t calibration_raw;     // 0x05
+        uint16_t alert_mask_raw;      // 0x06
+        uint16_t alert_limit_raw;     // 0x07
+        uint8_t alert_type;           // AlertType du registre 0x07
+        uint8_t reserved0;
+        uint16_t shunt_res_milliohm;
+        uint32_t current_lsb_na;      // Current_LSB en nA (Power_LSB = 25 × Current_LSB)
+        uint32_t reserved1;
+        int64_t epoch_offset_us;      // heure murale (µs Unix) correspondant à timestamp_us = 0
+        uint8_t reserved[16];
+    };
+    static_assert(sizeof(CaptureFileHeader) == 64, "CaptureFileHeader doit faire 64 octets");
+
+    /// En-tête de bloc : bornes temporelles pour la recherche, CRC des enregistrements
+    struct CaptureBlockHeader
+    {
+        uint32_t magic;
+        uint32_t count;               // enregistrements valides dans le bloc
+        int64_t first_us;
+        int64_t last_us;
+        uint32_t sequence;
+        uint32_t crc32;               // CRC des `count` enregistrements
+    };
+    static_assert(sizeof(CaptureBlockHeader) == 32, "CaptureBlockHeader doit faire 32 octets");
+
+    /// Enregistrement brut : registres 0x01..0x04 et décalage par rapport à first_us du bloc
+    struct CaptureRecord
+    {
+        uint32_t offset_us;
+        int16_t shunt;
+        uint16_t bus;
+        uint16_t power;
+        int16_t current;
+    };
+    static_assert(sizeof(CaptureRecord) == 12, "CaptureRecord doit faire 12 octets");
+
+    /// Entrée d'index : horodatage du premier enregistrement de chaque bloc
+    struct CaptureIndexEntry
+    {
+        int64_t first_us;
+    };
+
+    /// Pied de fichier, toujours les 16 derniers octets d'une capture fermée proprement
+    struct CaptureFooter
+    {
+        uint32_t magic;
+        uint32_t block_count;
+        uint64_t index_offset;
+    };
+    static_assert(sizeof(CaptureFooter) == 16, "CaptureFooter doit faire 16 octets");
+
+    /// Position d'un enregistrement dans la capture
+    struct CapturePosition
+    {
+        size_t block = 0;
+        size_t index = 0;
+    };
+
+    inline constexpr uint32_t capture_block_size(uint32_t samples_per_block)
+    {
+        return sizeof(CaptureBlockHeader) + samples_per_block * sizeof(CaptureRecord);
+    }
+
+} // namespace ina226
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "config/ina226-basic_config.hpp"
+#include "ina226-common_types.hpp"
+#include "ina226-error.hpp"
+#include "ina226-trace.hpp"
+
+#include <esp_log.h>
+
+/**
+ * Définitions de BasicConfig<Bus>. À inclure uniquement pour instancier le pilote sur un
+ * autre bus que I2CDevices (instancié une fois dans ina226-config.cpp).
+ */
+namespace ina226
+{
+    template <typename Bus>
+    BasicConfig<Bus>::BasicConfig(Bus &dev, const ConfigParams &params)
+        : BasicInterface<Bus>(dev),
+          params_(params)
+    {}
+
+    template <typename Bus>
+    esp_err_t BasicConfig<Bus>::get_config(){
+        uint16_t config = 0;
+        RETURN_IF_ERROR(this->template read<reg::Configuration>(config));
+        params_.configuration.set_raw(config);
+        return ESP_OK;
+
+    }
+
+    template <typename Bus>
+    esp_err_t BasicConfig<Bus>::set_config(){
+        uint16_t config = params_.configuration.get_raw();
+        RETURN_IF_ERROR(this->template write<reg::Configuration>(config));
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicConfig<Bus>::get_calibration(){
+        uint16_t config = 0;
+        RETURN_IF_ERROR(this->template read<reg::Calibration>(config));
+        params_.calibration.set_raw(config);
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicConfig<Bus>::get_alert_mask(){
+        uint16_t config = 0;
+        RETURN_IF_ERROR(this->template read<reg::MaskEnable>(config));
+        params_.alert_mask.set_raw(config);
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicConfig<Bus>::get_alert_limit() {
+        uint16_t config = 0;
+        RETURN_IF_ERROR(this->template read<reg::AlertLimit>(config));
+        params_.alert_limit.set_raw(config);
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicConfig<Bus>::set_calibration(){
+        uint16_t config = params_.calibration.get_raw();
+        RETURN_IF_ERROR(this->template write<reg::Calibration>(config));
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicConfig<Bus>::set_alert_mask(){
+        uint16_t config = params_.alert_mask.get_raw();
+        RETURN_IF_ERROR(this->template write<reg::MaskEnable>(config));
+        return ESP_OK;
+    }
+ 
+    template <typename Bus>
+    esp_err_t BasicConfig<Bus>::set_alert_limit(){
+        uint16_t config = params_.alert_limit.get_raw();
+        RETURN_IF_ERROR(this->template write<reg::AlertLimit>(config));
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicConfig<Bus>::get(){
+        reg::Snapshot<reg::Configuration, reg::Calibration, reg::MaskEnable, reg::AlertLimit> regs;
+        RETURN_IF_ERROR(this->read_many(regs));
+        params_.configuration.set_raw(regs.get<reg::Configuration>());
+        params_.calibration.set_raw(regs.get<reg::Calibration>());
+        params_.alert_mask.set_raw(regs.get<reg::MaskEnable>());
+        params_.alert_limit.set_raw(regs.get<reg::AlertLimit>());
+        return ESP_OK;
+    }
+    template <typename Bus>
+    esp_err_t BasicConfig<Bus>::set(){
+        INA226_TRACE_SCOPE("Config::set");
+        RETURN_IF_ERROR(set_config());
+        RETURN_IF_ERROR(set_calibration());
+        RETURN_IF_ERROR(set_alert_mask());
+        RETURN_IF_ERROR(set_alert_limit());
+        return ESP_OK;
+    }
+
+} // namespace ina226
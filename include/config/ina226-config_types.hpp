@@ -1,7 +1,9 @@
 #pragma once
-#include <vector>
 #include <cstdint>
 #include <string>
+#include <string_view>
+
+#include "ina226-common_types.hpp"
 
 namespace ina226
 {
@@ -15,6 +17,31 @@ namespace ina226
         None
     };
 
+    struct AlertTypeInfo
+    {
+        std::string_view label;      // log
+        std::string_view key;        // JSON Mask/Enable
+        std::string_view name;       // JSON Alert Limit
+        std::string_view limit_unit; // log Alert Limit
+        uint16_t mask_bit;           // bit du registre 0x06
+    };
+
+    /// Indexée par AlertType, dans l'ordre de priorité des bits 15..11
+    inline constexpr AlertTypeInfo ALERT_TYPE_TABLE[] = {
+        {"Shunt Over Voltage", "shunt_over_voltage", "ShuntOverVoltage", "Shunt (µV)", reg::MaskEnable::SOL::mask},
+        {"Shunt Under Voltage", "shunt_under_voltage", "ShuntUnderVoltage", "Shunt (µV)", reg::MaskEnable::SUL::mask},
+        {"Bus Over Voltage", "bus_over_voltage", "BusOverVoltage", "Bus (mV)", reg::MaskEnable::BOL::mask},
+        {"Bus Under Voltage", "bus_under_voltage", "BusUnderVoltage", "Bus (mV)", reg::MaskEnable::BUL::mask},
+        {"Power Over Limit", "power_over_limit", "PowerOverLimit", "Power (mW)", reg::MaskEnable::POL::mask},
+        {"None", "none", "None", "None", 0},
+    };
+
+    inline constexpr const AlertTypeInfo &alert_type_info(AlertType type)
+    {
+        const auto i = static_cast<uint8_t>(type);
+        return ALERT_TYPE_TABLE[i <= static_cast<uint8_t>(AlertType::None) ? i : static_cast<uint8_t>(AlertType::None)];
+    }
+
     class ConfigurationRegister
     {
     public:
@@ -31,32 +58,34 @@ namespace ina226
             AVG_1024 = 0b111
         };
 
-        static std::string to_string(AveragingMode mode)
+        struct AveragingInfo
         {
-            using AM = ConfigurationRegister::AveragingMode;
-            switch (mode)
-            {
-            case AM::AVG_1:
-                return "1 sample";
-            case AM::AVG_4:
-                return "4 samples";
-            case AM::AVG_16:
-                return "16 samples";
-            case AM::AVG_64:
-                return "64 samples";
-            case AM::AVG_128:
-                return "128 samples";
-            case AM::AVG_256:
-                return "256 samples";
-            case AM::AVG_512:
-                return "512 samples";
-            case AM::AVG_1024:
-                return "1024 samples";
-            default:
-                return "Unknown";
-            }
+            std::string_view name;
+            uint16_t samples;
+        };
+
+        /// Indexée par la valeur des bits 9:11
+        static constexpr AveragingInfo AVERAGING_TABLE[8] = {
+            {"1 sample", 1},
+            {"4 samples", 4},
+            {"16 samples", 16},
+            {"64 samples", 64},
+            {"128 samples", 128},
+            {"256 samples", 256},
+            {"512 samples", 512},
+            {"1024 samples", 1024},
         };
 
+        static constexpr std::string_view to_string(AveragingMode mode)
+        {
+            return AVERAGING_TABLE[static_cast<uint8_t>(mode) & 0x07].name;
+        }
+
+        static constexpr uint16_t sample_count(AveragingMode mode)
+        {
+            return AVERAGING_TABLE[static_cast<uint8_t>(mode) & 0x07].samples;
+        }
+
         // Temps de conversion pour Bus ou Shunt (bits 3:5 ou 6:8)
         enum class ConversionTime : uint8_t
         {
@@ -70,30 +99,32 @@ namespace ina226
             CT_8244us = 0b111
         };
 
-        static std::string to_string(ConversionTime time)
+        struct ConversionTimeInfo
         {
-            using CT = ConfigurationRegister::ConversionTime;
-            switch (time)
-            {
-            case CT::CT_140us:
-                return "140 us";
-            case CT::CT_204us:
-                return "204 us";
-            case CT::CT_332us:
-                return "332 us";
-            case CT::CT_588us:
-                return "588 us";
-            case CT::CT_1100us:
-                return "1100 us";
-            case CT::CT_2116us:
-                return "2116 us";
-            case CT::CT_4156us:
-                return "4156 us";
-            case CT::CT_8244us:
-                return "8244 us";
-            default:
-                return "Unknown";
-            }
+            std::string_view name;
+            uint16_t us;
+        };
+
+        /// Indexée par la valeur des bits 3:5 / 6:8
+        static constexpr ConversionTimeInfo CONVERSION_TIME_TABLE[8] = {
+            {"140 us", 140},
+            {"204 us", 204},
+            {"332 us", 332},
+            {"588 us", 588},
+            {"1100 us", 1100},
+            {"2116 us", 2116},
+            {"4156 us", 4156},
+            {"8244 us", 8244},
+        };
+
+        static constexpr std::string_view to_string(ConversionTime time)
+        {
+            return CONVERSION_TIME_TABLE[static_cast<uint8_t>(time) & 0x07].name;
+        }
+
+        static constexpr uint16_t conversion_time_us(ConversionTime time)
+        {
+            return CONVERSION_TIME_TABLE[static_cast<uint8_t>(time) & 0x07].us;
         }
 
         enum class OperatingMode : uint8_t
@@ -107,31 +138,25 @@ namespace ina226
             ShuntAndBusContinuous = 0b111
         };
 
-        static std::string to_string(OperatingMode mode)
+        /// Indexée par la valeur des bits 0:2 (0b100 est aussi un Power-Down)
+        static constexpr std::string_view OPERATING_MODE_TABLE[8] = {
+            "Power-Down",
+            "Shunt Triggered",
+            "Bus Triggered",
+            "Shunt + Bus Triggered",
+            "Power-Down",
+            "Shunt Continuous",
+            "Bus Continuous",
+            "Shunt + Bus Continuous",
+        };
+
+        static constexpr std::string_view to_string(OperatingMode mode)
         {
-            using OM = ConfigurationRegister::OperatingMode;
-            switch (mode)
-            {
-            case OM::PowerDown:
-                return "Power-Down";
-            case OM::ShuntTriggered:
-                return "Shunt Triggered";
-            case OM::BusTriggered:
-                return "Bus Triggered";
-            case OM::ShuntAndBusTriggered:
-                return "Shunt + Bus Triggered";
-            case OM::ShuntContinuous:
-                return "Shunt Continuous";
-            case OM::BusContinuous:
-                return "Bus Continuous";
-            case OM::ShuntAndBusContinuous:
-                return "Shunt + Bus Continuous";
-            default:
-                return "Unknown";
-            }
+            return OPERATING_MODE_TABLE[static_cast<uint8_t>(mode) & 0x07];
         }
 
-        static constexpr uint8_t reg_addr = 0x00;
+        using descriptor = reg::Configuration;
+        static constexpr uint8_t reg_addr = descriptor::addr;
 
         struct ConfigurationReg
         {
@@ -147,8 +172,14 @@ namespace ina226
         void set_values(ConfigurationReg values);
         ConfigurationReg get_values() const;
 
+        /// Durée d'un cycle de mesure complet (µs) : temps de conversion des voies actives × moyenne
+        uint32_t conversion_period_us() const;
+
         void log() const;
         std::string to_json() const;
+        /// Variante sans allocation ; retourne la longueur écrite
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 160;
 
     private:
         uint16_t raw_ = 0;
@@ -162,26 +193,94 @@ namespace ina226
             uint16_t shunt_res_milliohm = 100;
             uint16_t max_current_ma = 10000;
         };
-    
-        static constexpr uint8_t reg_addr = 0x05;
+
+        /// Résultat du calcul de calibration
+        struct Solution
+        {
+            bool valid = false;
+            uint16_t cal = 0;                  // valeur du registre 0x05
+            uint32_t current_lsb_ua = 0;       // Current_LSB visé (µA entiers)
+            uint32_t current_lsb_na = 0;       // Current_LSB effectif après arrondi de CAL
+            uint32_t power_lsb_uw = 0;         // Power_LSB effectif = 25 × Current_LSB
+            int32_t quantization_error_ppm = 0; // (effectif − visé) / visé
+        };
+
+        /**
+         * Calcul en temps constant du plus petit Current_LSB (µA entiers) qui :
+         *  - couvre max_current_ma sur les 15 bits positifs du registre courant :
+         *    lsb ≥ ⌈max_current_ma × 1000 / 32767⌉ ;
+         *  - garde CAL = ⌊CAL_CONST / (lsb × R)⌋ ≤ 32767, soit lsb × R > CAL_CONST / 32768 :
+         *    lsb ≥ ⌈(⌊CAL_CONST / 32768⌋ + 1) / R⌉.
+         * Utilisable à la compilation comme à l'exécution.
+         *
+         * Écart voulu avec l'ancienne recherche (⌈max_current_ma × 1000 / 32768⌉) : quand
+         * 1000 × max_current_ma ∈ ]32767 k, 32768 k] pour un entier k, le LSB visé passe de k
+         * à k + 1 µA, l'ancien plaçant max_current_ma au-delà de 32767 pas. 2007 valeurs
+         * de 1 à 65535 mA (1409, 1835, 2392… 32768, 65535) ; CAL ne change que si la borne
+         * de plage l'emporte et que la troncature diffère (ex. 132 valeurs à 100 mΩ).
+         */
+        static constexpr Solution solve(CalibrationReg values)
+        {
+            Solution s;
+            const uint32_t r = values.shunt_res_milliohm;
+            if (r == 0 || values.max_current_ma == 0)
+                return s;
+
+            const uint32_t lsb_range = (static_cast<uint32_t>(values.max_current_ma) * 1000 + MAX_CAL - 1) / MAX_CAL;
+            const uint32_t lsb_cal = (CAL_CONST / (MAX_CAL + 1) + 1 + r - 1) / r;
+            const uint32_t lsb = lsb_range > lsb_cal ? lsb_range : lsb_cal;
+
+            const uint64_t denom = static_cast<uint64_t>(lsb) * r;
+            const uint32_t cal = static_cast<uint32_t>(CAL_CONST / denom);
+            if (cal == 0) // shunt × courant hors de portée du registre
+                return s;
+
+            // Current_LSB réel imposé par la troncature de CAL : 0.00512 / (CAL × R)
+            const uint64_t cal_denom = static_cast<uint64_t>(cal) * r;
+            const uint32_t lsb_na = static_cast<uint32_t>((static_cast<uint64_t>(CAL_CONST) * 1000 + cal_denom / 2) / cal_denom);
+
+            s.valid = true;
+            s.cal = static_cast<uint16_t>(cal);
+            s.current_lsb_ua = lsb;
+            s.current_lsb_na = lsb_na;
+            s.power_lsb_uw = (lsb_na * 25 + 500) / 1000;
+            s.quantization_error_ppm = static_cast<int32_t>(
+                (static_cast<int64_t>(lsb_na) - static_cast<int64_t>(lsb) * 1000) * 1000 / lsb);
+            return s;
+        }
+
+        using descriptor = reg::Calibration;
+        static constexpr uint8_t reg_addr = descriptor::addr;
 
         void set_raw(uint16_t raw) { raw_ = raw; }
         uint16_t get_raw() const { return raw_; }
 
+        /// Applique solve() ; registre inchangé si la combinaison est invalide
         void set_value(CalibrationReg values);
         uint16_t get_value() const{ return raw_; }
 
         void log() const;
         std::string to_json() const;
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 24;
 
     private:
         uint16_t raw_ = 0;
     };
 
+    // 100 mΩ / 3.2 A : LSB 98 µA, CAL = ⌊5120000 / 9800⌋ = 522
+    static_assert(CalibrationRegister::solve({100, 3200}).cal == 522);
+    static_assert(CalibrationRegister::solve({100, 3200}).current_lsb_ua == 98);
+    // 1 mΩ / 100 mA : la borne CAL ≤ 32767 l'emporte (LSB 157 µA)
+    static_assert(CalibrationRegister::solve({1, 100}).cal == 32611);
+    // 100 mΩ / 32768 mA : 1000 µA mettrait 32768 mA un pas au-delà de 32767 → 1001 µA
+    static_assert(CalibrationRegister::solve({100, 32768}).current_lsb_ua == 1001);
+
     class MaskEnableRegister
     {
     public:
-        static constexpr uint8_t reg_addr = 0x06;
+        using descriptor = reg::MaskEnable;
+        static constexpr uint8_t reg_addr = descriptor::addr;
         uint16_t value = 0;
 
         struct MaskEnableReg
@@ -206,6 +305,8 @@ namespace ina226
 
         void log() const;
         std::string to_json() const;
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 160;
 
     private:
         uint16_t raw_ = 0;
@@ -214,7 +315,8 @@ namespace ina226
     class AlertLimitRegister
     {
     public:
-        static constexpr uint8_t reg_addr = 0x07;
+        using descriptor = reg::AlertLimit;
+        static constexpr uint8_t reg_addr = descriptor::addr;
 
         void set_type(AlertType type) { type_ = type; }
         AlertType get_type() const { return type_; }
@@ -227,6 +329,8 @@ namespace ina226
 
         void log() const;
         std::string to_json() const;
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 80;
 
     private:
         AlertType type_ = AlertType::None;
@@ -242,6 +346,9 @@ namespace ina226
 
         void log() const;
         std::string to_json() const;
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = ConfigurationRegister::JSON_SIZE + CalibrationRegister::JSON_SIZE +
+                                            MaskEnableRegister::JSON_SIZE + AlertLimitRegister::JSON_SIZE + 80;
     };
 
 };
\ No newline at end of file
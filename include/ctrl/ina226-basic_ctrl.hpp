@@ -0,0 +1,94 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstdint>
+#include <string>
+
+#include "ina226-bus_interface.hpp"
+#include "ina226-common_types.hpp"
+#include "ctrl/ina226-convert.hpp"
+
+namespace ina226
+{
+    /// Fenêtre pendant laquelle les registres de résultat ne changent pas
+    struct CoherentWindow
+    {
+        uint32_t period_us = 0; // période de conversion attendue ; 0 : vérification CVRF systématique
+        uint32_t guard_us = 0;  // marge retirée de la période
+        uint8_t max_retries = 2;
+
+        /// Marge de 10 % (tolérance de l'oscillateur interne) + 20 µs (latence d'ISR)
+        static constexpr CoherentWindow for_period(uint32_t period_us)
+        {
+            return {period_us, period_us / 10 + 20, 2};
+        }
+    };
+
+    /// Résultat d'une lecture cohérente
+    struct CoherentSample
+    {
+        RawSample raw;
+        uint16_t mask_enable = 0; // 0x06 au début de la lecture, drapeaux des relectures cumulés
+        bool coherent = false;    // 0x01..0x04 issus d'une même conversion
+        bool verified = false;    // cohérence établie par relecture de CVRF plutôt que par la fenêtre
+        uint8_t retries = 0;
+    };
+
+    /**
+     * @class BasicCTRL
+     * @brief Lecture des mesures (registres 0x01..0x04) sur le bus `Bus`.
+     * Définitions dans ctrl/ina226-ctrl_impl.hpp ; CTRL est l'instance I2CDevices.
+     */
+    template <typename Bus>
+    class BasicCTRL : public BasicInterface<Bus>
+    {
+    public:
+        explicit BasicCTRL(Bus &dev) : BasicInterface<Bus>(dev) {}
+
+        int32_t shunt_voltage_uv;
+        uint32_t bus_voltage_mv;
+        uint32_t power_mw;
+        int32_t current_ma;
+
+        esp_err_t ready();
+        esp_err_t send_reset();
+
+        esp_err_t get_shunt_voltage();
+        esp_err_t get_bus_voltage();
+        esp_err_t get_power();
+        esp_err_t get_current();
+        esp_err_t get();
+
+        /**
+         * Facteurs LSB → mA / mW de get_current() et get_power(), ceux que la chaîne de
+         * traitement applique via convert_sample() : à fixer après écriture de la calibration
+         * (ConversionScale::from_calibration). Par défaut, hypothèse CURRENT_LSB_MA.
+         */
+        void set_scale(const ConversionScale &scale) { scale_ = scale; }
+        const ConversionScale &scale() const { return scale_; }
+
+        /// Lit les registres 0x01..0x04 sans conversion, horodatés (esp_timer)
+        esp_err_t get_raw(RawSample &out);
+
+        /**
+         * Lit 0x06 puis 0x01..0x04 sans mélanger deux conversions.
+         * Si la lecture se termine dans la fenêtre ouverte par la fin de conversion `ready_us`
+         * (front ALERT avec CNVR), elle est cohérente sans transaction supplémentaire. Sinon
+         * 0x06 est relu : CVRF absent confirme la lecture, CVRF levé signale une conversion
+         * terminée pendant la lecture, qui est alors recommencée.
+         * @param ready_us instant de fin de conversion, 0 si inconnu
+         */
+        esp_err_t get_coherent(CoherentSample &out, int64_t ready_us, const CoherentWindow &window);
+
+        void log() const;
+        std::string to_json() const;
+        /// Variante sans allocation ; retourne la longueur écrite
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 96;
+
+    private:
+        inline static const char *TAG = "INA226-CTRL";
+        ConversionScale scale_;
+    };
+
+} // namespace ina226
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ina226-common_types.hpp"
+
+namespace ina226
+{
+    /// Current_LSB en nA déduit du registre de calibration : 0.00512 / (CAL × R).
+    /// Sans calibration, retombe sur l'hypothèse CURRENT_LSB_MA du pilote.
+    inline uint32_t current_lsb_na(uint16_t calibration_raw, uint16_t shunt_res_milliohm)
+    {
+        const uint64_t denom = static_cast<uint64_t>(calibration_raw) * shunt_res_milliohm;
+        if (denom == 0)
+            return CURRENT_LSB_MA * 1000000u;
+        return static_cast<uint32_t>((static_cast<uint64_t>(CAL_CONST) * 1000 + denom / 2) / denom);
+    }
+
+    /**
+     * @struct ConversionScale
+     * @brief Facteurs LSB → unités physiques pour une calibration donnée.
+     */
+    struct ConversionScale
+    {
+        float shunt_uv_per_lsb = SHUNT_LSB_UV_X10 / 10.0f;
+        float bus_mv_per_lsb = BUS_LSB_UV / 1000.0f;
+        float current_ma_per_lsb = CURRENT_LSB_MA;
+        float power_mw_per_lsb = POWER_LSB_MW;
+
+        /// À partir du Current_LSB en nA (Power_LSB = 25 × Current_LSB)
+        static ConversionScale from_current_lsb_na(uint32_t current_lsb_na);
+
+        /// À partir du registre de calibration et du shunt : Current_LSB = 0.00512 / (CAL × R)
+        static ConversionScale from_calibration(uint16_t calibration_raw, uint16_t shunt_res_milliohm);
+    };
+
+    // === Noyaux vectoriels (SoA) ===
+    // Boucles simples sans dépendance entre itérations pour l'auto-vectorisation,
+    // avec un chemin SSE2 explicite sur x86 (outils hôte).
+
+    void convert_s16(const int16_t *raw, float *out, size_t count, float scale);
+    void convert_u16(const uint16_t *raw, float *out, size_t count, float scale);
+
+    inline void convert_shunt_uv(const int16_t *raw, float *out, size_t count, const ConversionScale &s = {})
+    {
+        convert_s16(raw, out, count, s.shunt_uv_per_lsb);
+    }
+
+    inline void convert_bus_mv(const uint16_t *raw, float *out, size_t count, const ConversionScale &s = {})
+    {
+        convert_u16(raw, out, count, s.bus_mv_per_lsb);
+    }
+
+    inline void convert_current_ma(const int16_t *raw, float *out, size_t count, const ConversionScale &s)
+    {
+        convert_s16(raw, out, count, s.current_ma_per_lsb);
+    }
+
+    inline void convert_power_mw(const uint16_t *raw, float *out, size_t count, const ConversionScale &s)
+    {
+        convert_u16(raw, out, count, s.power_mw_per_lsb);
+    }
+
+    /// Conversion d'un seul échantillon : chemin de la tâche d'acquisition, sans tampons de paquet sur la pile
+    inline Measurement convert_sample(const RawSample &in, const ConversionScale &s)
+    {
+        Measurement m;
+        m.timestamp_us = in.timestamp_us;
+        m.shunt_uv = in.shunt * s.shunt_uv_per_lsb;
+        m.bus_mv = in.bus * s.bus_mv_per_lsb;
+        m.current_ma = in.current * s.current_ma_per_lsb;
+        m.power_mw = in.power * s.power_mw_per_lsb;
+        return m;
+    }
+
+    /// Conversion AoS RawSample → Measurement, par paquets désentrelacés vers les noyaux SoA
+    void convert_samples(const RawSample *in, Measurement *out, size_t count, const ConversionScale &s);
+
+    /// Référence scalaire, un échantillon à la fois (comparaison des noyaux)
+    void convert_samples_scalar(const RawSample *in, Measurement *out, size_t count, const ConversionScale &s);
+
+} // namespace ina226
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cinttypes>
+#include <cmath>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "ctrl/ina226-basic_ctrl.hpp"
+#include "ina226-clock.hpp"
+#include "ina226-error.hpp"
+#include "ina226-format.hpp"
+#include "ina226-trace.hpp"
+
+/**
+ * Définitions de BasicCTRL<Bus>. À inclure uniquement pour instancier le pilote sur un
+ * autre bus que I2CDevices (instancié une fois dans ina226-ctrl.cpp).
+ */
+namespace ina226
+{
+    template <typename Bus>
+    esp_err_t BasicCTRL<Bus>::ready()
+    {
+        uint16_t value;
+        RETURN_IF_ERROR(this->template read<reg::ManufacturerId>(value));
+        if (value != reg::ManufacturerId::TI) return ESP_ERR_INVALID_RESPONSE;
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicCTRL<Bus>::send_reset()
+    {
+        uint16_t config;
+        RETURN_IF_ERROR(this->template read<reg::Configuration>(config));
+        config = reg::Configuration::RST::set(config, 1);
+        RETURN_IF_ERROR(this->template write<reg::Configuration>(config));
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicCTRL<Bus>::get_shunt_voltage()
+    {
+        int16_t val;
+        RETURN_IF_ERROR(this->template read<reg::ShuntVoltage>(val));
+        shunt_voltage_uv = ((val * SHUNT_LSB_UV_X10) / 10);
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicCTRL<Bus>::get_bus_voltage()
+    {
+        uint16_t val;
+        RETURN_IF_ERROR(this->template read<reg::BusVoltage>(val));
+        bus_voltage_mv = (val * BUS_LSB_UV) / 1000;
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicCTRL<Bus>::get_current()
+    {
+        int16_t val;
+        RETURN_IF_ERROR(this->template read<reg::Current>(val));
+        current_ma = static_cast<int32_t>(std::lround(val * scale_.current_ma_per_lsb));
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicCTRL<Bus>::get_power()
+    {
+        uint16_t val;
+        RETURN_IF_ERROR(this->template read<reg::Power>(val));
+        power_mw = static_cast<uint32_t>(std::lround(val * scale_.power_mw_per_lsb));
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicCTRL<Bus>::get()
+    {
+        INA226_TRACE_SCOPE("CTRL::get");
+        RETURN_IF_ERROR(get_shunt_voltage());
+        RETURN_IF_ERROR(get_bus_voltage());
+        RETURN_IF_ERROR(get_power());
+        RETURN_IF_ERROR(get_current());
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicCTRL<Bus>::get_raw(RawSample &out)
+    {
+        INA226_TRACE_SCOPE("CTRL::get_raw");
+        out.timestamp_us = clock::now_us();
+        RETURN_IF_ERROR((this->template read_many<reg::ShuntVoltage, reg::BusVoltage, reg::Power, reg::Current>(
+            out.shunt, out.bus, out.power, out.current)));
+        return ESP_OK;
+    }
+
+    template <typename Bus>
+    esp_err_t BasicCTRL<Bus>::get_coherent(CoherentSample &out, int64_t ready_us, const CoherentWindow &window)
+    {
+        INA226_TRACE_SCOPE("CTRL::get_coherent");
+        using ME = reg::MaskEnable;
+        uint16_t mask = 0;
+        RETURN_IF_ERROR(this->template read<ME>(mask)); // acquitte CVRF
+        out.mask_enable = mask;
+        out.coherent = false;
+        out.verified = false;
+        out.retries = 0;
+
+        // Échéance transmise à l'arbitre du bus (set_arbiter), effacée en sortie
+        struct DeadlineScope
+        {
+            int64_t &deadline;
+            ~DeadlineScope() { deadline = 0; }
+        } deadline_scope{this->sample_deadline_us_};
+
+        // Fin de la conversion lue au plus tôt ; inconnue sans front daté
+        int64_t anchor = ready_us;
+        while (true)
+        {
+            this->sample_deadline_us_ =
+                window.period_us && anchor ? anchor + window.period_us - window.guard_us : 0;
+            const int64_t start = clock::now_us();
+            RETURN_IF_ERROR(get_raw(out.raw));
+            const int64_t end = clock::now_us();
+            if (window.period_us && anchor && end - anchor + window.guard_us <= window.period_us)
+            {
+                out.coherent = true;
+                return ESP_OK;
+            }
+
+            // Fenêtre inconnue ou dépassée : une conversion s'est-elle terminée pendant la lecture ?
+            RETURN_IF_ERROR(this->template read<ME>(mask));
+            out.mask_enable |= mask & ~ME::CVRF::mask;
+            out.verified = true;
+            if (!ME::CVRF::test(mask))
+            {
+                out.coherent = true;
+                return ESP_OK;
+            }
+            if (out.retries >= window.max_retries)
+                return ESP_OK;
+
+            // La nouvelle conversion s'est terminée après `start` : elle ouvre la fenêtre suivante
+            ++out.retries;
+            anchor = start;
+        }
+    }
+
+    template <typename Bus>
+    void BasicCTRL<Bus>::log() const
+    {
+        ESP_LOGI(TAG, "Shunt voltage : %d µV", shunt_voltage_uv);
+        ESP_LOGI(TAG, "Bus voltage   : %u mV", bus_voltage_mv);
+        ESP_LOGI(TAG, "Current       : %d mA", current_ma);
+        ESP_LOGI(TAG, "Power         : %u mW", power_mw);
+    }
+
+    template <typename Bus>
+    size_t BasicCTRL<Bus>::to_json(char *buf, size_t len) const
+    {
+        return format_to(buf, len,
+                         "{\"shunt_uv\": %" PRId32 ",\"bus_mv\": %" PRIu32 ",\"current_ma\": %" PRId32
+                         ",\"power_mw\": %" PRIu32 "}",
+                         shunt_voltage_uv, bus_voltage_mv, current_ma, power_mw);
+    }
+
+    template <typename Bus>
+    std::string BasicCTRL<Bus>::to_json() const
+    {
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
+    }
+
+} // namespace ina226
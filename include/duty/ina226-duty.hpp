@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+
+#include "ina226-common_types.hpp"
+#include "config/ina226-config.hpp"
+#include "ctrl/ina226-ctrl.hpp"
+#include "ctrl/ina226-convert.hpp"
+
+namespace ina226
+{
+    /// Modèle de consommation pour l'estimation d'énergie (valeurs typiques de la fiche technique)
+    struct EnergyModel
+    {
+        float supply_v = 3.3f;
+        float active_current_ua = 330.0f;  // IQ en conversion
+        float shutdown_current_ua = 0.5f;  // IQ en Power-Down
+        float pullup_ohm = 4700.0f;        // tirages SDA/SCL
+        uint32_t i2c_frequency_hz = 100000;
+    };
+
+    /// Cadence de réveil : `burst_count` conversions toutes les `period_ms`
+    struct DutyCycleConfig
+    {
+        uint32_t period_ms = 1000;
+        uint16_t burst_count = 1;
+        uint32_t burst_interval_ms = 0; // 0 : conversions enchaînées
+        bool light_sleep = true;        // light sleep de l'ESP pendant les attentes (hors cible linux)
+        EnergyModel energy = {};
+    };
+
+    struct DutyCycleStats
+    {
+        static constexpr uint32_t BITS_PER_TRANSACTION = 48; // adresse, registre, 2 octets, ACK, START/STOP
+
+        uint32_t samples = 0;
+        uint32_t cycles = 0;
+        uint32_t i2c_transactions = 0;
+        int64_t active_us = 0;  // composant hors Power-Down (déclenchement → lecture)
+        int64_t elapsed_us = 0; // depuis start()
+        int64_t sleep_us = 0;   // temps passé en light sleep
+
+        /// Fraction du temps où le composant convertit
+        float duty_cycle() const { return elapsed_us ? static_cast<float>(active_us) / elapsed_us : 0.0f; }
+
+        float sensor_energy_uj_per_sample(const EnergyModel &m) const;
+        float bus_energy_uj_per_sample(const EnergyModel &m) const;
+    };
+
+    /**
+     * @class DutyCycleScheduler
+     * @brief Échantillonnage basse consommation : Power-Down entre deux mesures, réveil en
+     *        mode ShuntAndBusTriggered à cadence fixe ou par rafales.
+     *
+     * Chaque mesure écrit la configuration en mode déclenché, attend la période de
+     * conversion (en light sleep si elle est assez longue), relève CVRF puis lit les
+     * registres de résultat et replace le composant en Power-Down. Le light sleep suspend
+     * tout le système : à réserver aux nœuds dont cette tâche rythme l'activité.
+     */
+    class DutyCycleScheduler
+    {
+    public:
+        DutyCycleScheduler(Config &cfg, CTRL &ctrl) : cfg_(cfg), ctrl_(ctrl) {}
+
+        /// Lit la configuration courante, conserve ses temps de conversion et passe en Power-Down
+        esp_err_t start(const DutyCycleConfig &config);
+
+        /// Une mesure déclenchée complète, composant replacé en Power-Down
+        esp_err_t sample(Measurement &out);
+
+        /**
+         * Un cycle : la rafale de mesures puis l'attente du cycle suivant.
+         * @param out   au moins burst_count éléments
+         * @param count nombre de mesures réussies écrites dans `out`
+         */
+        esp_err_t run_cycle(Measurement *out, size_t max, size_t &count);
+
+        /// Remet la configuration lue au start() (mode continu d'origine)
+        esp_err_t stop();
+
+        const DutyCycleStats &stats() const { return stats_; }
+        void log() const;
+
+    private:
+        static constexpr int64_t LIGHT_SLEEP_MIN_US = 2000;
+
+        esp_err_t write_config(uint16_t raw);
+        /// Attend la fin nominale `ready_us` puis relève CVRF, un tick entre deux lectures
+        esp_err_t wait_ready(int64_t ready_us, int64_t deadline_us);
+        void sleep_until(int64_t wake_us);
+
+        Config &cfg_;
+        CTRL &ctrl_;
+        DutyCycleConfig config_{};
+        ConversionScale scale_{};
+
+        uint16_t saved_raw_ = 0;   // configuration d'origine
+        uint16_t trigger_raw_ = 0; // mêmes réglages, mode ShuntAndBusTriggered
+        uint16_t park_raw_ = 0;    // mêmes réglages, mode PowerDown
+        uint32_t period_us_ = 0;
+
+        int64_t started_us_ = 0;
+        int64_t next_cycle_us_ = 0;
+        DutyCycleStats stats_{};
+
+        inline static const char *TAG = "INA226-DUTY";
+    };
+
+} // namespace ina226
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "esp_err.h"
+
+#include "ina226-common_types.hpp"
+#include "ina226-stats.hpp"
+#include "config/ina226-config.hpp"
+#include "ctrl/ina226-ctrl.hpp"
+
+namespace ina226
+{
+    enum class HealthFault : uint8_t
+    {
+        None,
+        MissingEdge,  // pas de conversion depuis missing_edge_periods périodes (CNVR actif)
+        FrozenValue,  // registres de résultat identiques sur frozen_samples lectures
+        BusError,     // bus_error_threshold erreurs I2C consécutives
+        MathOverflow, // OVF levé dans Mask/Enable
+        COUNT
+    };
+
+    /// Étapes de reprise, de la moins intrusive à la plus intrusive
+    enum class RecoveryStep : uint8_t
+    {
+        Reread,    // relecture (acquitte 0x06, relâche ALERT)
+        Reapply,   // réécriture de la configuration, calibration et alertes, relue pour contrôle
+        SoftReset, // CTRL::send_reset() puis réécriture de la configuration
+        COUNT
+    };
+
+    inline constexpr std::string_view HEALTH_FAULT_NAMES[] = {
+        "None", "Missing Edge", "Frozen Value", "Bus Error", "Math Overflow"};
+    inline constexpr std::string_view RECOVERY_STEP_NAMES[] = {"Re-read", "Re-apply", "Soft Reset"};
+
+    constexpr std::string_view to_string(HealthFault fault) { return HEALTH_FAULT_NAMES[static_cast<uint8_t>(fault)]; }
+    constexpr std::string_view to_string(RecoveryStep step) { return RECOVERY_STEP_NAMES[static_cast<uint8_t>(step)]; }
+
+    struct HealthConfig
+    {
+        uint32_t missing_edge_periods = 8;
+        // 0 (défaut) : désactivé. Une charge stable relue avec moyennage donne des registres
+        // identiques en fonctionnement normal ; à n'activer que si le bruit garantit une variation
+        uint32_t frozen_samples = 0;
+        uint32_t bus_error_threshold = 3;
+        uint32_t retry_interval_ms = 100; // entre deux reprises complètes échouées
+    };
+
+    struct HealthStats
+    {
+        uint32_t faults[static_cast<size_t>(HealthFault::COUNT)] = {};
+        uint32_t recovered_by[static_cast<size_t>(RecoveryStep::COUNT)] = {};
+        uint32_t failed_recoveries = 0; // reprises où aucune étape n'a suffi
+        TimingStats time_to_recover;    // détection → retour à la normale (MTTR = moyenne)
+    };
+
+    /**
+     * @class HealthMonitor
+     * @brief Surveillance de la chaîne d'acquisition et reprise automatique par paliers.
+     *
+     * La tâche d'acquisition rapporte chaque lecture (on_sample) ou échec (on_bus_error)
+     * et appelle check() lorsqu'elle se réveille sans front ALERT. Un défaut détecté est
+     * traité par recover() : relecture, puis réécriture de la configuration, puis soft
+     * reset suivi de la réécriture (le reset ramène tous les registres à leur valeur par
+     * défaut). Chaque étape est validée par une vérification propre au défaut.
+     */
+    class HealthMonitor
+    {
+    public:
+        HealthMonitor(Config &cfg, CTRL &ctrl, HealthConfig config = {});
+
+        /// À appeler une fois le composant configuré : cfg.datas() devient l'état de référence
+        void start(int64_t now_us);
+
+        void on_sample(const RawSample &raw, uint16_t mask_enable);
+        void on_bus_error(esp_err_t err);
+
+        /// Évalue l'absence de conversion et retourne le défaut courant
+        HealthFault check(int64_t now_us);
+
+        /// Reprise par paliers ; ESP_OK si le défaut est levé
+        esp_err_t recover();
+
+        /// Délai d'attente d'un front au-delà duquel check() signale MissingEdge (0 : non surveillé)
+        uint32_t edge_timeout_ms() const;
+
+        HealthFault fault() const { return fault_; }
+        const HealthStats &stats() const { return stats_; }
+        void log() const;
+
+    private:
+        void raise(HealthFault fault, int64_t now_us);
+        void clear(int64_t now_us);
+        esp_err_t run_step(RecoveryStep step);
+        esp_err_t reapply_and_verify();
+        esp_err_t verify();
+        uint32_t period_us() const;
+
+        Config &cfg_;
+        CTRL &ctrl_;
+        HealthConfig config_;
+
+        bool expect_edges_ = false;
+        int64_t last_sample_us_ = 0;
+        RawSample last_raw_{};
+        uint32_t identical_ = 0;
+        uint32_t bus_errors_ = 0;
+
+        HealthFault fault_ = HealthFault::None;
+        int64_t fault_since_us_ = 0;
+        int64_t last_attempt_us_ = 0;
+        HealthStats stats_;
+
+        inline static const char *TAG = "INA226-HEALTH";
+    };
+
+} // namespace ina226
@@ -0,0 +1,334 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "sdkconfig.h"
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "ina226-common_types.hpp"
+
+// Profondeur des anneaux (Kconfig, menu INA226 Memory)
+#ifndef CONFIG_INA226_HISTORY_SECONDS
+#define CONFIG_INA226_HISTORY_SECONDS 120
+#endif
+#ifndef CONFIG_INA226_HISTORY_MINUTES
+#define CONFIG_INA226_HISTORY_MINUTES 120
+#endif
+#ifndef CONFIG_INA226_HISTORY_HOURS
+#define CONFIG_INA226_HISTORY_HOURS 168
+#endif
+
+namespace ina226
+{
+    /// Période d'historique close (24 octets) ; index : numéro absolu de la période
+    struct HistoryBucket
+    {
+        static constexpr uint32_t EMPTY = UINT32_MAX;
+
+        uint32_t index = EMPTY;
+        uint32_t count = 0;
+        float min_mw = 0.0f;
+        float max_mw = 0.0f;
+        float mean_mw = 0.0f;
+        float energy_mj = 0.0f;
+    };
+
+    /// Point d'une série retournée par HistoryStore::series()
+    struct HistoryPoint
+    {
+        int64_t start_us;
+        uint32_t count;
+        float min_mw;
+        float max_mw;
+        float mean_mw;
+        float energy_mj;
+    };
+
+    /// Agrégat d'une plage de temps
+    struct HistorySummary
+    {
+        int64_t start_us = 0;     // début de la première période retenue
+        int64_t end_us = 0;       // fin de la dernière période retenue
+        uint32_t resolution_s = 0; // résolution de l'anneau interrogé ; 0 : aucune donnée
+        uint32_t buckets = 0;
+        uint64_t count = 0;
+        float min_mw = 0.0f;
+        float max_mw = 0.0f;
+        float mean_mw = 0.0f;
+        double energy_mj = 0.0;
+
+        void add(int64_t start_us, int64_t end_us, uint32_t count, float min_mw, float max_mw, double sum_mw,
+                 double energy_mj);
+
+        void log() const;
+        std::string to_json() const;
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 256;
+    };
+
+    /**
+     * @class HistoryRing
+     * @brief Anneau de Slots périodes de ResolutionS secondes.
+     *
+     * La période en cours est cumulée en double (somme et énergie) puis rangée, à sa
+     * clôture, dans l'emplacement index % Slots. Un emplacement dont l'index ne correspond
+     * pas à la période recherchée est vide (trou d'acquisition, anneau pas encore rempli) :
+     * aucune remise à zéro n'est nécessaire au passage d'un trou.
+     */
+    template <uint32_t ResolutionS, size_t Slots>
+    class HistoryRing
+    {
+        static_assert(ResolutionS > 0 && Slots > 0, "anneau vide");
+
+    public:
+        static constexpr uint32_t RESOLUTION_S = ResolutionS;
+        static constexpr size_t SLOTS = Slots;
+        static constexpr int64_t RESOLUTION_US = static_cast<int64_t>(ResolutionS) * 1000000;
+
+        void add(int64_t t_us, float power_mw, double energy_mj)
+        {
+            const uint32_t index = index_of(t_us);
+            if (open_.index == HistoryBucket::EMPTY || index > open_.index)
+            {
+                close();
+                open_ = Open{index};
+                if (first_ == HistoryBucket::EMPTY)
+                    first_ = index;
+            }
+            // Horodatage antérieur à la période ouverte : compté dans celle-ci
+            ++open_.count;
+            if (power_mw < open_.min_mw)
+                open_.min_mw = power_mw;
+            if (power_mw > open_.max_mw)
+                open_.max_mw = power_mw;
+            open_.sum_mw += power_mw;
+            open_.energy_mj += energy_mj;
+        }
+
+        /// Vrai si l'anneau contient encore tout ce qui a été acquis depuis `from_us`
+        bool covers(int64_t from_us) const
+        {
+            if (open_.index == HistoryBucket::EMPTY)
+                return false;
+            const uint32_t from = index_of(from_us);
+            return from >= oldest() || first_ >= oldest();
+        }
+
+        /// Nombre de périodes de [from_us, to_us) au plus retenues par l'anneau
+        size_t span(int64_t from_us, int64_t to_us) const
+        {
+            uint32_t lo, hi;
+            return bounds(from_us, to_us, lo, hi) ? hi - lo + 1 : 0;
+        }
+
+        /// Cumule dans `out` les périodes qui recouvrent [from_us, to_us)
+        void query(int64_t from_us, int64_t to_us, HistorySummary &out) const
+        {
+            visit(from_us, to_us, [&](uint32_t index, uint32_t count, float mn, float mx, double sum, double e) {
+                const int64_t start = static_cast<int64_t>(index) * RESOLUTION_US;
+                out.add(start, start + RESOLUTION_US, count, mn, mx, sum, e);
+            });
+            out.resolution_s = ResolutionS;
+        }
+
+        /// Copie dans `out` les périodes non vides de [from_us, to_us), dans l'ordre
+        size_t series(int64_t from_us, int64_t to_us, HistoryPoint *out, size_t max) const
+        {
+            size_t n = 0;
+            visit(from_us, to_us, [&](uint32_t index, uint32_t count, float mn, float mx, double sum, double e) {
+                if (n < max)
+                    out[n++] = {static_cast<int64_t>(index) * RESOLUTION_US, count, mn, mx,
+                                static_cast<float>(sum / count), static_cast<float>(e)};
+            });
+            return n;
+        }
+
+        void reset()
+        {
+            for (auto &b : ring_)
+                b.index = HistoryBucket::EMPTY;
+            open_ = Open{};
+            first_ = HistoryBucket::EMPTY;
+        }
+
+    private:
+        /// Période en cours, cumulée sans perte de précision sur une heure à 3,5 kHz
+        struct Open
+        {
+            uint32_t index = HistoryBucket::EMPTY;
+            uint32_t count = 0;
+            float min_mw = INFINITY;
+            float max_mw = -INFINITY;
+            double sum_mw = 0.0;
+            double energy_mj = 0.0;
+        };
+
+        static uint32_t index_of(int64_t t_us)
+        {
+            return t_us <= 0 ? 0 : static_cast<uint32_t>(t_us / RESOLUTION_US);
+        }
+
+        /// Plus ancienne période encore présente dans l'anneau
+        uint32_t oldest() const
+        {
+            return open_.index >= Slots - 1 ? open_.index - static_cast<uint32_t>(Slots - 1) : 0;
+        }
+
+        /// Indices [lo, hi] de la requête bornés au contenu de l'anneau ; faux si disjoints
+        bool bounds(int64_t from_us, int64_t to_us, uint32_t &lo, uint32_t &hi) const
+        {
+            if (open_.index == HistoryBucket::EMPTY || to_us <= from_us)
+                return false;
+            lo = index_of(from_us);
+            hi = index_of(to_us - 1);
+            if (lo < oldest())
+                lo = oldest();
+            if (hi > open_.index)
+                hi = open_.index;
+            return lo <= hi;
+        }
+
+        /// Au plus Slots emplacements parcourus, quelle que soit la plage demandée
+        template <typename F>
+        void visit(int64_t from_us, int64_t to_us, F &&f) const
+        {
+            uint32_t lo, hi;
+            if (!bounds(from_us, to_us, lo, hi))
+                return;
+            for (uint32_t i = lo;; ++i)
+            {
+                if (i == open_.index)
+                {
+                    if (open_.count)
+                        f(i, open_.count, open_.min_mw, open_.max_mw, open_.sum_mw, open_.energy_mj);
+                }
+                else
+                {
+                    const HistoryBucket &b = ring_[i % Slots];
+                    if (b.index == i)
+                        f(i, b.count, b.min_mw, b.max_mw, static_cast<double>(b.mean_mw) * b.count, b.energy_mj);
+                }
+                if (i == hi)
+                    break;
+            }
+        }
+
+        void close()
+        {
+            if (open_.index == HistoryBucket::EMPTY || !open_.count)
+                return;
+            ring_[open_.index % Slots] = {open_.index,
+                                          open_.count,
+                                          open_.min_mw,
+                                          open_.max_mw,
+                                          static_cast<float>(open_.sum_mw / open_.count),
+                                          static_cast<float>(open_.energy_mj)};
+        }
+
+        HistoryBucket ring_[Slots];
+        Open open_;
+        uint32_t first_ = HistoryBucket::EMPTY;
+    };
+
+    /**
+     * @class HistoryStore
+     * @brief Historique de puissance multi-résolution (1 s, 1 min, 1 h), mémoire fixe.
+     *
+     * Alimenté échantillon par échantillon par la tâche de traitement
+     * (INA226Manager::attach_history) : chaque mesure met à jour la période ouverte des trois
+     * anneaux, sans relecture des échantillons bruts. L'énergie est intégrée par la méthode
+     * des trapèzes entre deux mesures consécutives ; un écart supérieur à max_gap_s n'est
+     * pas intégré (acquisition interrompue).
+     *
+     * Les requêtes interrogent l'anneau le plus fin qui couvre encore le début de la plage
+     * et parcourent au plus sa profondeur. Elles peuvent venir de toute tâche.
+     */
+    class HistoryStore
+    {
+        static_assert(std::is_trivially_copyable_v<HistoryRing<1, 1>>, "save() copie les anneaux tels quels");
+
+    public:
+        using Seconds = HistoryRing<1, CONFIG_INA226_HISTORY_SECONDS>;
+        using Minutes = HistoryRing<60, CONFIG_INA226_HISTORY_MINUTES>;
+        using Hours = HistoryRing<3600, CONFIG_INA226_HISTORY_HOURS>;
+
+        enum class Resolution : uint8_t
+        {
+            Auto,
+            Second,
+            Minute,
+            Hour
+        };
+
+        explicit HistoryStore(uint32_t max_gap_s = 60);
+
+        HistoryStore(const HistoryStore &) = delete;
+        HistoryStore &operator=(const HistoryStore &) = delete;
+
+        void add(const Measurement &m);
+
+        /// Agrégat de [from_us, to_us) (horloge esp_timer) ; resolution_s = 0 si aucune donnée
+        HistorySummary query(int64_t from_us, int64_t to_us, Resolution res = Resolution::Auto) const;
+
+        /// Agrégat des `seconds` dernières secondes avant la dernière mesure
+        HistorySummary last(uint32_t seconds) const;
+
+        /**
+         * Série de [from_us, to_us) pour un graphique. En Auto, anneau le plus fin qui couvre
+         * la plage en au plus `max` points ; retourne le nombre de points écrits.
+         */
+        size_t series(int64_t from_us, int64_t to_us, HistoryPoint *out, size_t max,
+                      Resolution res = Resolution::Auto) const;
+
+        /// Dernière mesure, en temps de l'historique (esp_timer + offset_us())
+        int64_t last_us() const;
+
+        /// Décalage appliqué aux horodatages esp_timer ; non nul après load()
+        int64_t offset_us() const;
+
+        /**
+         * Image binaire des anneaux (persistance) ; retourne SNAPSHOT_SIZE, 0 si `len` est
+         * insuffisant. L'image n'est relisible que par une compilation de mêmes profondeurs.
+         */
+        size_t save(uint8_t *buf, size_t len) const;
+
+        /**
+         * Recharge une image de save(). L'horloge esp_timer repartant de zéro au démarrage et
+         * la durée de l'arrêt étant inconnue, la chronologie reprend à la dernière mesure
+         * sauvegardée : les horodatages suivants sont décalés de offset_us().
+         */
+        esp_err_t load(const uint8_t *buf, size_t len);
+
+        void reset();
+
+        static constexpr size_t MEMORY_BYTES =
+            (Seconds::SLOTS + Minutes::SLOTS + Hours::SLOTS) * sizeof(HistoryBucket);
+        static constexpr size_t SNAPSHOT_SIZE = 20 + sizeof(Seconds) + sizeof(Minutes) + sizeof(Hours);
+
+    private:
+        Resolution pick(int64_t from_us, int64_t to_us, size_t max_points) const;
+
+        Seconds seconds_;
+        Minutes minutes_;
+        Hours hours_;
+
+        int64_t max_gap_us_;
+        int64_t last_us_ = 0;
+        float last_mw_ = 0.0f;
+        bool has_last_ = false;
+        int64_t offset_us_ = 0;
+        bool rebase_ = false; // load() : offset_us_ fixé à la mesure suivante
+
+        // Mutex statique : aucune allocation au premier verrouillage (CONFIG_INA226_HEAP_FREE)
+        StaticSemaphore_t lock_buf_;
+        SemaphoreHandle_t lock_;
+    };
+
+} // namespace ina226
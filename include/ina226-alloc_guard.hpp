@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+
+namespace ina226
+{
+    /**
+     * Garde d'allocation (CONFIG_INA226_ALLOC_GUARD) : compte les appels à operator new
+     * et, une fois armée, signale toute allocation comme une violation.
+     * Sans l'option, les fonctions existent mais ne comptent rien.
+     */
+    namespace alloc_guard
+    {
+        /// Arme la garde ; `fatal` : abort() à la première allocation
+        void arm(bool fatal = true);
+        void disarm();
+        bool armed();
+
+        /// Allocations depuis le démarrage
+        uint32_t count();
+        /// Allocations survenues pendant que la garde était armée
+        uint32_t violations();
+    } // namespace alloc_guard
+} // namespace ina226
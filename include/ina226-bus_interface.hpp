@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "arbiter/ina226-arbiter.hpp"
+#include "ina226-registers.hpp"
+
+namespace ina226
+{
+    /**
+     * @class BasicInterface
+     * @brief Interface bas-niveau pour accéder aux registres du INA226, paramétrée par le bus.
+     *
+     * `Bus` fournit, sans fonction virtuelle :
+     *   esp_err_t read(uint8_t reg, uint8_t *data, size_t len);
+     *   esp_err_t write(uint8_t reg, const uint8_t *data, size_t len);
+     * I2CDevices (ESP-IDF), SimBus (registres en mémoire) et ReplayBus (capture rejouée)
+     * conviennent ; les appels au transport sont résolus et inlinés à la compilation.
+     */
+    template <typename Bus>
+    class BasicInterface
+    {
+    public:
+        using bus_type = Bus;
+
+        explicit BasicInterface(Bus &i2c_device) : i2c(i2c_device) {}
+
+        esp_err_t read_register(uint8_t reg, uint8_t *data, size_t len)
+        {
+            esp_err_t err = ESP_FAIL;
+            const int max_attempts = 3;
+
+            for (int attempt = 0; attempt < max_attempts; ++attempt)
+            {
+                err = transact(reg, false, [&] { return i2c.read(reg, data, len); });
+                if (err == ESP_OK)
+                {
+                    //ESP_LOGI(TAG, "I2C READ -> Reg: 0x%02X | Len: %d", reg, static_cast<int>(len));
+                    //ESP_LOG_BUFFER_HEX_LEVEL(TAG, data, len, ESP_LOG_INFO);
+                    return ESP_OK;
+                }
+                vTaskDelay(pdMS_TO_TICKS(10));
+            }
+
+            ESP_LOGW(TAG, "Read failed at reg 0x%02X after %d attempts (err=0x%x)", reg, max_attempts, err);
+            return err;
+        }
+
+        esp_err_t write_register(uint8_t reg, const uint8_t *data, size_t len)
+        {
+            esp_err_t err = ESP_FAIL;
+            err = transact(reg, true, [&] { return i2c.write(reg, data, len); });
+            if (err == ESP_OK)
+            {
+                // ESP_LOGI(TAG, "I2C WRITE -> Reg: 0x%02X | Len: %d", reg, static_cast<int>(len));
+                // ESP_LOG_BUFFER_HEX_LEVEL(TAG, data, len, ESP_LOG_INFO);
+                return ESP_OK;
+            }
+
+            ESP_LOGW(TAG, "Write failed at reg 0x%02X (err=0x%x)", reg, err);
+            return err;
+        }
+
+        esp_err_t read_u16(uint8_t reg, uint16_t &out)
+        {
+            uint8_t raw[2];
+            esp_err_t err = read_register(reg, raw, 2);
+            if (err != ESP_OK)
+                return err;
+            out = ((raw[0] << 8) | raw[1]);
+            return ESP_OK;
+        }
+
+        esp_err_t read_s16(uint8_t reg, int16_t &out)
+        {
+            uint8_t raw[2];
+            esp_err_t err = read_register(reg, raw, 2);
+            if (err != ESP_OK)
+                return err;
+            out = ((static_cast<int16_t>(raw[0]) << 8) | raw[1]);
+            return ESP_OK;
+        }
+
+        esp_err_t write_u16(uint8_t reg_addr, uint16_t value)
+        {
+            // INA226 utilise un format Big Endian : MSB d'abord
+            uint8_t buffer[3];
+            buffer[0] = reg_addr;                       // adresse du registre à écrire
+            buffer[1] = (value >> 8) & 0xFF;            // MSB
+            buffer[2] = value & 0xFF;                   // LSB
+            // i2c_.write(reg, data, len)
+            return transact(reg_addr, true, [&] { return i2c.write(buffer[0], &buffer[1], 2); });
+        }
+
+        /**
+         * Fait passer chaque transaction par l'arbitre d'un bus partagé (nullptr : accès direct).
+         * Classe déduite du registre (BusArbiter::classify) ; chaque tentative de
+         * read_register() est une demande distincte, le bus est libre pendant les reprises.
+         */
+        void set_arbiter(BusArbiter *arbiter) { arbiter_ = arbiter; }
+
+        /// Lecture typée d'un registre de la table reg:: (signe et adresse résolus à la compilation)
+        template <typename Reg>
+        esp_err_t read(typename Reg::value_type &out)
+        {
+            if constexpr (Reg::is_signed)
+                return read_s16(Reg::addr, out);
+            else
+                return read_u16(Reg::addr, out);
+        }
+
+        template <typename Reg>
+        esp_err_t write(typename Reg::value_type value)
+        {
+            static_assert(Reg::writable, "registre en lecture seule");
+            return write_u16(Reg::addr, static_cast<uint16_t>(value));
+        }
+
+        /// Lit les registres `Regs` dans l'ordre ; s'arrête à la première erreur
+        template <typename... Regs>
+        esp_err_t read_many(typename Regs::value_type &...out)
+        {
+            esp_err_t err = ESP_OK;
+            ((void)(err == ESP_OK ? (err = read<Regs>(out)) : err), ...);
+            return err;
+        }
+
+        template <typename... Regs>
+        esp_err_t read_many(reg::Snapshot<Regs...> &snapshot)
+        {
+            return read_many<Regs...>(snapshot.template get<Regs>()...);
+        }
+
+    protected:
+        Bus &i2c;
+        /// Échéance des lectures de mesure en cours (BasicCTRL::get_coherent) ; 0 : aucune
+        int64_t sample_deadline_us_ = 0;
+
+    private:
+        template <typename F>
+        esp_err_t transact(uint8_t reg, bool write, F &&op)
+        {
+            if (!arbiter_)
+                return op();
+            const BusPriority priority = BusArbiter::classify(reg, write);
+            BusArbiter::Guard guard(*arbiter_, priority,
+                                    priority == BusPriority::Sample ? sample_deadline_us_ : 0);
+            if (guard.status() != ESP_OK)
+                return guard.status();
+            return op();
+        }
+
+        BusArbiter *arbiter_ = nullptr;
+
+        inline static const char *TAG = "INA226-INTERFACE";
+    };
+
+} // namespace ina226
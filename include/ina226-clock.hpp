@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+#include "sdkconfig.h"
+
+#include "esp_timer.h"
+
+namespace ina226
+{
+    /**
+     * Horloge des échantillons : horodatage des mesures et des fronts ALERT, et toute
+     * durée comparée à ces horodatages (cadence, cohérence, surveillance, historique).
+     * esp_timer sur la cible. Sur la cible "linux", un ReplayBus la remplace par le
+     * temps enregistré de la capture, ce qui garde ces fonctions exactes en rejeu
+     * accéléré. Les durées purement matérielles (écritures, attente du bus) restent
+     * mesurées avec esp_timer.
+     */
+    namespace clock
+    {
+#if CONFIG_IDF_TARGET_LINUX
+        using Source = int64_t (*)(void *ctx);
+
+        /// Remplace l'horloge (nullptr : retour à esp_timer) ; à appeler hors acquisition
+        void set_source(Source source, void *ctx);
+        int64_t now_us();
+#else
+        inline int64_t now_us() { return esp_timer_get_time(); }
+#endif
+    } // namespace clock
+
+} // namespace ina226
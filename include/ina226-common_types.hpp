@@ -1,6 +1,8 @@
 #pragma once
 #include <cstdint>
 
+#include "ina226-registers.hpp"
+
 namespace ina226 {
 
     // === Constantes de calcul ===
@@ -8,19 +10,19 @@ namespace ina226 {
     /// Facteur de calibration : 0.00512 / Current_LSB → utilisé pour compute_calibration()
     static constexpr uint32_t CAL_FACTOR = 5120; // 0.00512 / 0.001 = 5120
 
-    // === Constantes LSB exprimées en unités entières ===
+    // === Constantes LSB exprimées en unités entières (dérivées de la table reg::) ===
 
     /// Shunt Voltage Register LSB : 2.5 µV → exprimé en dixièmes de µV pour rester en entier
-    static constexpr uint16_t SHUNT_LSB_UV_X10 = 25; // 2.5 µV × 10
+    static constexpr uint16_t SHUNT_LSB_UV_X10 = reg::ShuntVoltage::lsb / 100; // 2.5 µV × 10
 
     /// Bus Voltage Register LSB : 1.25 mV = 1250 µV
-    static constexpr uint16_t BUS_LSB_UV = 1250;
+    static constexpr uint16_t BUS_LSB_UV = reg::BusVoltage::lsb / 1000;
 
     /// Current Register LSB (hypothèse de Current_LSB = 1 mA)
     static constexpr uint16_t CURRENT_LSB_MA = 1;
 
     /// Power Register LSB : 25 × Current_LSB = 25 mW
-    static constexpr uint16_t POWER_LSB_MW = 25;
+    static constexpr uint16_t POWER_LSB_MW = reg::Power::lsb * CURRENT_LSB_MA;
 
     /// Facteur d’échelle entre courant et puissance
     /// (Current_LSB = 1 mA → Power = current × POWER_FACTOR)
@@ -29,4 +31,26 @@ namespace ina226 {
     static constexpr uint32_t MAX_CAL = 32767;
     
     static constexpr uint32_t CAL_CONST = 5120000; // = 0.00512 / (µA * mOhm)
+
+    // === Échantillons ===
+
+    /// Registres de mesure bruts (0x01..0x04) lus lors d'une même acquisition, horodatés en µs
+    struct RawSample
+    {
+        int64_t timestamp_us = 0;
+        int16_t shunt = 0;    // 0x01, LSB 2.5 µV
+        uint16_t bus = 0;     // 0x02, LSB 1.25 mV
+        uint16_t power = 0;   // 0x03, LSB 25 × Current_LSB
+        int16_t current = 0;  // 0x04, LSB Current_LSB
+    };
+
+    /// Échantillon converti en unités physiques
+    struct Measurement
+    {
+        int64_t timestamp_us = 0;
+        float shunt_uv = 0.0f;
+        float bus_mv = 0.0f;
+        float current_ma = 0.0f;
+        float power_mw = 0.0f;
+    };
 }
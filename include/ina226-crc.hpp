@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace ina226
+{
+    /// CRC-32 (IEEE 802.3, polynôme réfléchi 0xEDB88320), sans table pour rester léger en flash.
+    /// `seed` permet de chaîner plusieurs appels : crc32(b, nb, crc32(a, na)).
+    inline uint32_t crc32(const void *data, size_t len, uint32_t seed = 0)
+    {
+        const uint8_t *p = static_cast<const uint8_t *>(data);
+        uint32_t crc = ~seed;
+        for (size_t i = 0; i < len; ++i)
+        {
+            crc ^= p[i];
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+        return ~crc;
+    }
+} // namespace ina226
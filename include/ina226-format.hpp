@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+
+namespace ina226
+{
+    /**
+     * snprintf sur un tampon fourni par l'appelant, sans allocation.
+     * Retourne le nombre de caractères effectivement écrits (hors '\0'),
+     * tronqué à len - 1 : les appels peuvent donc être chaînés sur buf + n.
+     */
+    inline size_t format_to(char *buf, size_t len, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+    inline size_t format_to(char *buf, size_t len, const char *fmt, ...)
+    {
+        if (len == 0)
+            return 0;
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(buf, len, fmt, args);
+        va_end(args);
+        if (n < 0)
+        {
+            buf[0] = '\0';
+            return 0;
+        }
+        return static_cast<size_t>(n) < len ? static_cast<size_t>(n) : len - 1;
+    }
+
+    inline const char *bool_str(bool v) { return v ? "true" : "false"; }
+} // namespace ina226
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+/**
+ * Table des registres INA226 évaluée à la compilation : adresse, signe, LSB, champs et mode
+ * d'accès. Seule source des adresses et des positions de bits du composant ; CTRL, Config,
+ * STATUS, le rejeu et le moniteur de santé s'y réfèrent.
+ *
+ *   uint16_t me;
+ *   ctrl.read<reg::MaskEnable>(me);
+ *   if (reg::MaskEnable::AFF::test(me)) ...  // (me & 0x0010) != 0
+ */
+namespace ina226
+{
+    namespace reg
+    {
+        enum class Access : uint8_t
+        {
+            ReadOnly,
+            ReadWrite,
+        };
+
+        /// Unité du LSB d'un registre
+        enum class Unit : uint8_t
+        {
+            None,       // valeur brute (configuration, drapeaux)
+            Nanovolt,   // LSB fixe, en nV
+            CurrentLsb, // multiple du Current_LSB fixé par la calibration
+        };
+
+        /// Champ de `Width` bits à partir du bit `Shift` ; se réduit à un décalage et un masque
+        template <uint8_t Shift, uint8_t Width = 1>
+        struct Field
+        {
+            static_assert(Width > 0 && Shift + Width <= 16, "champ hors du registre 16 bits");
+
+            static constexpr uint8_t shift = Shift;
+            static constexpr uint8_t width = Width;
+            static constexpr uint16_t mask = static_cast<uint16_t>(((1u << Width) - 1u) << Shift);
+
+            static constexpr uint16_t get(uint16_t raw) { return (raw & mask) >> Shift; }
+            static constexpr bool test(uint16_t raw) { return (raw & mask) != 0; }
+            static constexpr uint16_t set(uint16_t raw, uint16_t value)
+            {
+                return static_cast<uint16_t>((raw & ~mask) | ((value << Shift) & mask));
+            }
+        };
+
+        template <uint8_t Addr, typename Value, Access A, Unit U = Unit::None, uint32_t Lsb = 1>
+        struct Register
+        {
+            static_assert(std::is_same_v<Value, uint16_t> || std::is_same_v<Value, int16_t>,
+                          "les registres INA226 font 16 bits");
+
+            using value_type = Value;
+            static constexpr uint8_t addr = Addr;
+            static constexpr bool is_signed = std::is_signed_v<Value>;
+            static constexpr Access access = A;
+            static constexpr bool writable = A == Access::ReadWrite;
+            static constexpr Unit unit = U;
+            static constexpr uint32_t lsb = Lsb; // dans l'unité `unit`
+            /// La lecture a un effet de bord sur le composant (drapeaux effacés)
+            static constexpr bool read_clears = false;
+        };
+
+        struct Configuration : Register<0x00, uint16_t, Access::ReadWrite>
+        {
+            using RST = Field<15>;
+            using AVG = Field<9, 3>;
+            using VBUSCT = Field<6, 3>;
+            using VSHCT = Field<3, 3>;
+            using MODE = Field<0, 3>;
+        };
+
+        struct ShuntVoltage : Register<0x01, int16_t, Access::ReadOnly, Unit::Nanovolt, 2500>
+        {
+        };
+
+        struct BusVoltage : Register<0x02, uint16_t, Access::ReadOnly, Unit::Nanovolt, 1250000>
+        {
+        };
+
+        struct Power : Register<0x03, uint16_t, Access::ReadOnly, Unit::CurrentLsb, 25>
+        {
+        };
+
+        struct Current : Register<0x04, int16_t, Access::ReadOnly, Unit::CurrentLsb, 1>
+        {
+        };
+
+        struct Calibration : Register<0x05, uint16_t, Access::ReadWrite>
+        {
+            using CAL = Field<0, 15>; // bit 15 réservé
+        };
+
+        struct MaskEnable : Register<0x06, uint16_t, Access::ReadWrite>
+        {
+            // Fonctions d'alerte (RW), une seule active à la fois ; la plus haute l'emporte
+            using SOL = Field<15>;
+            using SUL = Field<14>;
+            using BOL = Field<13>;
+            using BUL = Field<12>;
+            using POL = Field<11>;
+            using CNVR = Field<10>;
+            // Drapeaux (R)
+            using AFF = Field<4>;
+            using CVRF = Field<3>;
+            using OVF = Field<2>;
+            // Polarité et verrouillage de la broche ALERT (RW)
+            using APOL = Field<1>;
+            using LEN = Field<0>;
+
+            static constexpr uint16_t FUNCTIONS = SOL::mask | SUL::mask | BOL::mask | BUL::mask | POL::mask;
+            static constexpr uint16_t WRITABLE = FUNCTIONS | CNVR::mask | APOL::mask | LEN::mask;
+            /// Lire 0x06 efface CVRF et, en mode verrouillé, AFF
+            static constexpr bool read_clears = true;
+        };
+
+        struct AlertLimit : Register<0x07, uint16_t, Access::ReadWrite>
+        {
+        };
+
+        struct ManufacturerId : Register<0xFE, uint16_t, Access::ReadOnly>
+        {
+            static constexpr uint16_t TI = 0x5449; // "TI"
+        };
+
+        struct DieId : Register<0xFF, uint16_t, Access::ReadOnly>
+        {
+            using DID = Field<4, 12>;
+            using RID = Field<0, 4>;
+        };
+
+        static_assert(MaskEnable::WRITABLE == 0xFC03);
+        static_assert(Configuration::AVG::set(0, 0b111) == 0x0E00);
+
+        /**
+         * Valeurs brutes d'un ensemble de registres lus par read_many() ; l'accès se fait par
+         * type de registre, l'indice est résolu à la compilation.
+         *
+         *   reg::Snapshot<reg::ShuntVoltage, reg::BusVoltage> s;
+         *   ctrl.read_many(s);
+         *   int16_t shunt = s.get<reg::ShuntVoltage>();
+         */
+        template <typename... Regs>
+        struct Snapshot
+        {
+            std::tuple<typename Regs::value_type...> values{};
+
+            template <typename Reg>
+            static constexpr size_t index_of()
+            {
+                constexpr bool match[] = {std::is_same_v<Reg, Regs>...};
+                size_t i = 0;
+                while (i < sizeof...(Regs) && !match[i])
+                    ++i;
+                return i;
+            }
+
+            template <typename Reg>
+            typename Reg::value_type &get()
+            {
+                static_assert(index_of<Reg>() < sizeof...(Regs), "registre absent du snapshot");
+                return std::get<index_of<Reg>()>(values);
+            }
+
+            template <typename Reg>
+            typename Reg::value_type get() const
+            {
+                static_assert(index_of<Reg>() < sizeof...(Regs), "registre absent du snapshot");
+                return std::get<index_of<Reg>()>(values);
+            }
+        };
+
+        /// Registres de mesure 0x01..0x04, dans l'ordre de RawSample
+        using Measurements = Snapshot<ShuntVoltage, BusVoltage, Power, Current>;
+    } // namespace reg
+
+} // namespace ina226
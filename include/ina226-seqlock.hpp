@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ina226
+{
+    /**
+     * @class SeqLock
+     * @brief Publication d'une valeur par un écrivain unique, lue sans verrou par un nombre
+     *        quelconque de lecteurs sur tout cœur.
+     *
+     * Variante à deux copies (« latch ») : l'écrivain met à jour la copie 0 pendant que les
+     * lecteurs lisent la copie 1, puis l'inverse, en incrémentant le compteur de séquence
+     * à chaque bascule. Un lecteur qui préempte l'écrivain au milieu d'une écriture lit la
+     * copie stable, sans attendre ; il ne recommence que si l'écrivain a progressé pendant
+     * sa lecture. Les copies sont des mots atomiques : pas de course au sens du modèle
+     * mémoire C++, et aucune instruction plus lourde qu'un accès 32 bits sur ESP32.
+     */
+    template <typename T>
+    class SeqLock
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "copie mot à mot");
+
+    public:
+        /// Écrivain unique
+        void store(const T &value)
+        {
+            uint32_t words[WORDS] = {};
+            std::memcpy(words, &value, sizeof(T));
+            const uint32_t s = seq_.load(std::memory_order_relaxed);
+            // Lecteurs vers la copie 1 (complète depuis l'appel précédent), écriture de la copie 0
+            seq_.store(s + 1, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_release);
+            write(0, words);
+            // Lecteurs vers la copie 0, écriture de la copie 1
+            seq_.store(s + 2, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_release);
+            write(1, words);
+        }
+
+        /**
+         * Copie cohérente de la dernière valeur publiée.
+         * @return faux si l'écrivain a publié à chaque essai pendant la lecture (`max_attempts`)
+         */
+        bool load(T &out, unsigned max_attempts = 4) const
+        {
+            uint32_t words[WORDS];
+            for (unsigned attempt = 0; attempt < max_attempts; ++attempt)
+            {
+                const uint32_t s = seq_.load(std::memory_order_acquire);
+                const auto &copy = data_[s & 1];
+                for (size_t i = 0; i < WORDS; ++i)
+                    words[i] = copy[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq_.load(std::memory_order_relaxed) == s)
+                {
+                    std::memcpy(&out, words, sizeof(T));
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// Nombre de publications (deux incréments par store())
+        uint32_t publications() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+    private:
+        static constexpr size_t WORDS = (sizeof(T) + 3) / 4;
+
+        void write(int copy, const uint32_t *words)
+        {
+            for (size_t i = 0; i < WORDS; ++i)
+                data_[copy][i].store(words[i], std::memory_order_relaxed);
+        }
+
+        std::atomic<uint32_t> seq_{0};
+        std::atomic<uint32_t> data_[2][WORDS] = {};
+    };
+} // namespace ina226
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+
+namespace ina226
+{
+    /**
+     * @class SimBus
+     * @brief Bus simulé : banc de registres 16 bits en mémoire, sans I2C ni verrou.
+     *
+     * Sert aux bancs d'essai et aux tests hôte du pilote (BasicCTRL<SimBus>, ...) :
+     * seul le coût du pilote est mesuré. Les écritures sont mémorisées telles quelles,
+     * sans reproduire les effets de bord du composant (voir ReplayBus pour cela).
+     */
+    class SimBus
+    {
+    public:
+        esp_err_t read(uint8_t reg, uint8_t *data, size_t len)
+        {
+            if (len != 2)
+                return ESP_ERR_INVALID_SIZE;
+            data[0] = static_cast<uint8_t>(regs_[reg] >> 8);
+            data[1] = static_cast<uint8_t>(regs_[reg] & 0xFF);
+            return ESP_OK;
+        }
+
+        esp_err_t write(uint8_t reg, const uint8_t *data, size_t len)
+        {
+            if (len != 2)
+                return ESP_ERR_INVALID_SIZE;
+            regs_[reg] = static_cast<uint16_t>((data[0] << 8) | data[1]);
+            return ESP_OK;
+        }
+
+        void set(uint8_t reg, uint16_t value) { regs_[reg] = value; }
+        uint16_t get(uint8_t reg) const { return regs_[reg]; }
+
+    private:
+        uint16_t regs_[256] = {};
+    };
+
+} // namespace ina226
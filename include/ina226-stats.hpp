@@ -0,0 +1,41 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+namespace ina226
+{
+    /// Statistiques glissantes d'un intervalle de temps (µs)
+    struct TimingStats
+    {
+        uint32_t count = 0;
+        int64_t min_us = INT64_MAX;
+        int64_t max_us = 0;
+        int64_t sum_us = 0;
+        uint64_t sum_sq_us = 0;
+
+        void add(int64_t us)
+        {
+            ++count;
+            if (us < min_us)
+                min_us = us;
+            if (us > max_us)
+                max_us = us;
+            sum_us += us;
+            sum_sq_us += static_cast<uint64_t>(us * us);
+        }
+
+        int64_t mean_us() const { return count ? sum_us / count : 0; }
+
+        /// Écart-type : la gigue autour de la moyenne
+        int64_t jitter_us() const
+        {
+            if (count < 2)
+                return 0;
+            const double mean = static_cast<double>(sum_us) / count;
+            const double var = static_cast<double>(sum_sq_us) / count - mean * mean;
+            return var > 0 ? static_cast<int64_t>(std::sqrt(var)) : 0;
+        }
+
+        void reset() { *this = TimingStats{}; }
+    };
+} // namespace ina226
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "sdkconfig.h"
+
+/**
+ * Points de trace (CONFIG_INA226_TRACE) : événements début/fin horodatés (esp_timer)
+ * dans un anneau de CONFIG_INA226_TRACE_RING_SIZE entrées, exportables au format
+ * Chrome/Perfetto (chrome://tracing, ui.perfetto.dev).
+ * Sans l'option, les macros ne génèrent aucun code et le module n'est pas compilé.
+ *
+ *   void CTRL::get() { INA226_TRACE_SCOPE("CTRL::get"); ... }
+ */
+#if CONFIG_INA226_TRACE
+
+namespace ina226
+{
+    namespace trace
+    {
+        struct Event
+        {
+            int64_t ts_us;
+            const char *name;      // littéral : seul le pointeur est conservé
+            const char *task_name; // tâche FreeRTOS émettrice
+            uint32_t task_id;
+            char phase;            // 'B' début, 'E' fin, 'i' instantané
+        };
+
+        void record(const char *name, char phase);
+
+        /// Copie les événements du plus ancien au plus récent ; à appeler tracé au repos
+        size_t snapshot(Event *out, size_t max);
+        void clear();
+        /// Événements écrasés depuis le dernier clear()
+        uint32_t overwritten();
+
+        /// Trace Event Format JSON ; retourne le nombre d'événements écrits
+        size_t export_chrome_json(FILE *stream, const Event *events, size_t count);
+
+        class Scope
+        {
+        public:
+            explicit Scope(const char *name) : name_(name) { record(name_, 'B'); }
+            ~Scope() { record(name_, 'E'); }
+
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            const char *name_;
+        };
+    } // namespace trace
+} // namespace ina226
+
+#define INA226_TRACE_CONCAT_(a, b) a##b
+#define INA226_TRACE_CONCAT(a, b) INA226_TRACE_CONCAT_(a, b)
+#define INA226_TRACE_SCOPE(name) ::ina226::trace::Scope INA226_TRACE_CONCAT(ina226_trace_, __LINE__){name}
+#define INA226_TRACE_BEGIN(name) ::ina226::trace::record(name, 'B')
+#define INA226_TRACE_END(name) ::ina226::trace::record(name, 'E')
+#define INA226_TRACE_INSTANT(name) ::ina226::trace::record(name, 'i')
+
+#else
+
+#define INA226_TRACE_SCOPE(name) do {} while (0)
+#define INA226_TRACE_BEGIN(name) do {} while (0)
+#define INA226_TRACE_END(name) do {} while (0)
+#define INA226_TRACE_INSTANT(name) do {} while (0)
+
+#endif
@@ -5,13 +5,28 @@
 #include "freertos/queue.h"
 #include "sdkconfig.h"
 
-#include "driver/gpio.h"
 #include "esp_log.h"
+#if !CONFIG_IDF_TARGET_LINUX
+#include "driver/gpio.h"
 #include "esp_intr_alloc.h"
+#endif
 
 #include "ctrl/ina226-ctrl.hpp"
+#include "ctrl/ina226-convert.hpp"
 #include "config/ina226-config.hpp"
 #include "status/ina226-status.hpp"
+#include "transient/ina226-transient.hpp"
+#include "telemetry/ina226-telemetry.hpp"
+#include "health/ina226-health.hpp"
+#include "rate/ina226-rate.hpp"
+#include "profile/ina226-profile.hpp"
+#include "history/ina226-history.hpp"
+#include "report/ina226-report.hpp"
+#include "persist/ina226-persist.hpp"
+#include "ina226-seqlock.hpp"
+#include "ina226-stats.hpp"
+
+#include <atomic>
 
 namespace ina226
 {
@@ -22,15 +37,193 @@ namespace ina226
         JSON
     };
 
+    /// Placement d'une tâche FreeRTOS
+    struct TaskPlacement
+    {
+        uint32_t stack_size;
+        UBaseType_t priority;
+        BaseType_t core;
+    };
+
+    /// Modèle de threads : acquisition (I2C seul) et traitement (conversion, alertes, sortie)
+    struct ThreadingConfig
+    {
+        bool split = true;              // false : une seule tâche fait acquisition et traitement
+        TaskPlacement acquisition = {3072, 10, 0};
+        TaskPlacement processing = {4096, 5, 0};
+        uint16_t queue_length = 32;
+
+        static ThreadingConfig from_kconfig();
+    };
+
+    /// Mesures de gigue de la chaîne d'acquisition, quel que soit le placement
+    struct PipelineStats
+    {
+        TimingStats acquisition_latency; // front ALERT → fin de lecture I2C
+        TimingStats processing_latency;  // front ALERT → fin de traitement
+        TimingStats sample_interval;     // entre deux lectures successives
+        uint32_t queue_overflows = 0;
+        uint32_t coherence_checks = 0;     // relectures de CVRF (lecture hors fenêtre connue)
+        uint32_t coherence_retries = 0;    // conversions terminées pendant une lecture
+        uint32_t incoherent_samples = 0;   // échantillons livrés malgré un chevauchement
+
+        void log() const;
+    };
+
+    /// Élément de la file acquisition → traitement
+    struct AcquiredSample
+    {
+        RawSample raw;
+        uint16_t mask_enable;
+        int64_t edge_us;
+        bool coherent; // 0x01..0x04 issus d'une même conversion (CTRL::get_coherent)
+    };
+
+    /// Dernier échantillon converti, publié par la tâche de traitement (INA226Manager::latest)
+    struct LatestSample
+    {
+        Measurement measurement;
+        uint16_t mask_enable;
+        bool coherent;
+        uint32_t sequence; // 1 au premier échantillon ; un écart signale des échantillons non lus
+    };
+
+    /// Mémoire des tâches et de la file fournie par l'application (mode sans tas)
+    struct StaticResources
+    {
+        StackType_t *acquisition_stack = nullptr;  // acquisition.stack_size octets
+        StaticTask_t *acquisition_tcb = nullptr;
+        StackType_t *processing_stack = nullptr;   // processing.stack_size octets (mode split)
+        StaticTask_t *processing_tcb = nullptr;
+        uint8_t *queue_storage = nullptr;          // queue_length × sizeof(AcquiredSample)
+        StaticQueue_t *queue = nullptr;
+    };
+
+    /**
+     * Stockage statique dimensionné à la compilation :
+     *   static ina226::StaticStorage<> storage;
+     *   manager.init(storage.threading(), storage.resources());
+     */
+    template <size_t AcqStackBytes = 3072, size_t ProcStackBytes = 4096, size_t QueueLength = 32>
+    struct StaticStorage
+    {
+        StackType_t acquisition_stack[AcqStackBytes / sizeof(StackType_t)];
+        StaticTask_t acquisition_tcb;
+        StackType_t processing_stack[ProcStackBytes / sizeof(StackType_t)];
+        StaticTask_t processing_tcb;
+        uint8_t queue_storage[QueueLength * sizeof(AcquiredSample)];
+        StaticQueue_t queue;
+
+        StaticResources resources()
+        {
+            return {acquisition_stack, &acquisition_tcb, processing_stack, &processing_tcb, queue_storage, &queue};
+        }
+
+        /// Placement Kconfig avec les tailles imposées par ce stockage
+        ThreadingConfig threading(ThreadingConfig t = ThreadingConfig::from_kconfig()) const
+        {
+            t.acquisition.stack_size = AcqStackBytes;
+            t.processing.stack_size = ProcStackBytes;
+            t.queue_length = QueueLength;
+            return t;
+        }
+    };
+
     class INA226Manager
     {
     public:
         INA226Manager(I2CDevices &i2c);
 
+        /// Appelé par la tâche de traitement pour chaque échantillon converti
+        using SampleCallback = void (*)(const Measurement &sample, void *ctx);
+
         // === API PUBLIQUE ===
 
-        /// Initialise la task
-        void init();
+#if !CONFIG_INA226_HEAP_FREE
+        /**
+         * Initialise les tâches (placement Kconfig par défaut).
+         * @return ESP_ERR_NO_MEM si la file ou une tâche ne peut être créée ; rien n'est conservé
+         */
+        esp_err_t init(const ThreadingConfig &threading = ThreadingConfig::from_kconfig());
+#endif
+
+        /// Initialise les tâches et la file dans la mémoire fournie, sans allocation
+        esp_err_t init(const ThreadingConfig &threading, const StaticResources &resources);
+
+        /// Sortie de chaque échantillon acquis par la tâche de traitement
+        void set_output_format(OutputFormat format) { output_format_ = format; }
+
+        /**
+         * Émission par exception (avant init()) : la sortie OutputFormat et le TelemetrySink
+         * ne reçoivent que les échantillons retenus par le filtre. Rappel, profil et
+         * historique reçoivent toujours tous les échantillons.
+         */
+        void set_report_filter(ReportFilter *filter) { report_ = filter; }
+
+        /// Branche un consommateur d'échantillons convertis (avant init())
+        void set_sample_callback(SampleCallback cb, void *ctx);
+
+        /**
+         * Branche une sortie par lots alimentée par la tâche de traitement (avant init()).
+         * Les lots sont aussi vidés sur l'âge maximal de FlushPolicy en l'absence de mesure.
+         */
+        void set_telemetry_sink(TelemetrySink *sink) { sink_ = sink; }
+
+        /// Branche un profil de charge (quantiles) alimenté par la tâche de traitement (avant init())
+        void attach_profile(LoadProfile *profile) { profile_ = profile; }
+
+        /// Branche un historique multi-résolution alimenté par la tâche de traitement (avant init())
+        void attach_history(HistoryStore *history) { history_ = history; }
+
+        /**
+         * Branche la sauvegarde des compteurs d'énergie (avant init(), après restore()).
+         * add() et poll() sont appelés par la tâche de traitement, qui porte donc la durée
+         * des écritures : la file d'échantillons doit couvrir PersistStats::write_duration.
+         */
+        void attach_persistence(StatePersistence *persist) { persist_ = persist; }
+
+        /**
+         * Copie des mesures de gigue depuis toute tâche : la part acquisition est publiée par la
+         * tâche d'acquisition après chaque lecture, la latence de traitement par la tâche de traitement.
+         * @return faux si une publication a coïncidé avec chaque essai de lecture
+         */
+        bool pipeline_stats(PipelineStats &out) const;
+
+        /**
+         * Copie des conversions lues, relues et perdues face à la cadence configurée, depuis
+         * toute tâche : publiée par la tâche d'acquisition après chaque lecture, comme latest().
+         */
+        bool rate_stats(RateStats &out) const { return rate_stats_.load(out); }
+
+        /// Demande la remise à zéro de rate_stats(), appliquée par la tâche d'acquisition avant sa prochaine lecture
+        void reset_rate_stats() { rate_reset_.store(true, std::memory_order_release); }
+
+        /**
+         * Branche la surveillance de santé sur la tâche d'acquisition (avant init()).
+         * Le moniteur doit être construit sur config() et ctrl() de ce gestionnaire.
+         */
+        void attach_health(HealthMonitor *monitor);
+
+        /**
+         * Fait passer toutes les transactions du composant par l'arbitre du bus partagé
+         * (avant init()). Les lectures de mesure passent devant la configuration et le
+         * trafic des autres périphériques ; BusArbiter::log() donne l'attente par classe.
+         */
+        void set_bus_arbiter(BusArbiter *arbiter);
+
+        Config &config() { return cfg_; }
+        CTRL &ctrl() { return ctrl_; }
+
+        /**
+         * Branche une capture de transitoire alimentée par la tâche de traitement (avant init()).
+         * Déclenchée par AFF ou trigger_transient(). Si `fast_post_trigger`, la tâche
+         * d'acquisition passe en 140 µs / 1 moyenne pendant la fenêtre post-déclenchement
+         * puis restaure la configuration.
+         */
+        void attach_transient(TransientCapture *capture, bool fast_post_trigger = true);
+
+        /// Déclenchement logiciel de la capture de transitoire (toute tâche)
+        void trigger_transient() { sw_trigger_.store(true, std::memory_order_relaxed); }
 
         /// Initialise la configuration (registre + alertes)
         esp_err_t init_device();
@@ -44,8 +237,22 @@ namespace ina226
         /// Gère une alerte si déclenchée par le GPIO
         esp_err_t handle_alert();
 
-        /// Récupère les mesures courantes
-        esp_err_t get_measurements(OutputFormat format = OutputFormat::None);
+        /// Signale un front ALERT depuis une tâche (rejeu, source autre que le GPIO)
+        void notify_alert();
+
+        /**
+         * Récupère les mesures courantes. Une fois les tâches démarrées, la mesure est le
+         * dernier échantillon publié (latest()) : aucune transaction I2C concurrente de la
+         * tâche d'acquisition. Avant init(), lecture directe des registres.
+         * @param filter si fourni, la sortie `format` n'a lieu que si le filtre retient la mesure
+         */
+        esp_err_t get_measurements(OutputFormat format = OutputFormat::None, ReportFilter *filter = nullptr);
+
+        /**
+         * Copie du dernier échantillon converti, sans verrou ni trafic I2C, depuis toute tâche
+         * et tout cœur, à toute cadence. Faux avant le premier échantillon.
+         */
+        bool latest(LatestSample &out) const { return latest_.publications() && latest_.load(out); }
 
         /// Optionnel : affichage état alertes/config
         esp_err_t get_status(OutputFormat format = OutputFormat::None);
@@ -54,7 +261,9 @@ namespace ina226
     private:
         I2CDevices &i2c_;
         Config cfg_;
+#if !CONFIG_IDF_TARGET_LINUX
         gpio_num_t alert_gpio_;
+#endif
         STATUS status_;
         CTRL ctrl_;
 
@@ -62,12 +271,67 @@ namespace ina226
         bool ready_ = false;
         esp_err_t is_ready();
 
+        ThreadingConfig threading_;
         TaskHandle_t task_handle_ = nullptr;
+        TaskHandle_t processing_handle_ = nullptr;
+        QueueHandle_t sample_queue_ = nullptr;
+        // Date du dernier front ALERT (0 : aucun) ; écrite par l'ISR, consommée par acquire()
+        portMUX_TYPE edge_lock_ = portMUX_INITIALIZER_UNLOCKED;
+        int64_t edge_us_ = 0;
+        int64_t take_edge();
+        void release_tasks();
+
+        OutputFormat output_format_ = OutputFormat::None;
+        SampleCallback sample_cb_ = nullptr;
+        void *sample_ctx_ = nullptr;
+        TelemetrySink *sink_ = nullptr;
+        ReportFilter *report_ = nullptr;
+        LoadProfile *profile_ = nullptr;
+        HistoryStore *history_ = nullptr;
+        StatePersistence *persist_ = nullptr;
+        HealthMonitor *health_ = nullptr;
+        ConversionScale scale_;
+        PipelineStats stats_;                       // tâche d'acquisition, hors processing_latency
+        TimingStats processing_latency_;            // tâche de traitement
+        SeqLock<PipelineStats> stats_published_;    // copie publiée de stats_
+        SeqLock<TimingStats> processing_published_; // copie publiée de processing_latency_
+        RateMonitor rate_;              // tâche d'acquisition
+        SeqLock<RateStats> rate_stats_; // copie publiée de rate_.stats()
+        std::atomic<bool> rate_reset_{false};
+        SeqLock<LatestSample> latest_;
+        uint32_t published_ = 0; // tâche de traitement
+
+        /// Changement de cadence demandé par le traitement, appliqué par l'acquisition
+        enum class RateRequest : uint8_t
+        {
+            None,
+            Fast,
+            Restore
+        };
+        TransientCapture *transient_ = nullptr;
+        bool transient_fast_ = true;
+        bool fast_requested_ = false; // tâche de traitement
+        bool fast_active_ = false;    // tâche d'acquisition
+        uint16_t saved_config_ = 0;
+        std::atomic<bool> sw_trigger_{false};
+        std::atomic<RateRequest> rate_request_{RateRequest::None};
+        int64_t last_sample_us_ = 0;
 
         static void task_wrapper(void *arg);
+        static void processing_wrapper(void *arg);
+#if !CONFIG_IDF_TARGET_LINUX
         static void IRAM_ATTR gpio_isr_handler(void *arg);
         void setup_interrupt(gpio_num_t gpio);
+#endif
+        bool alert_pin_active() const;
         void task_main();
+        void processing_main();
+        esp_err_t acquire(AcquiredSample &out);
+        void process(const AcquiredSample &sample);
+        void print_measurement(OutputFormat format, const Measurement &m) const;
+        void apply_rate_request();
+        TickType_t sink_poll_ticks() const;
+        TickType_t acquisition_wait_ticks() const;
     };
 
 } // namespace ina226
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#include "ina226-common_types.hpp"
+#include "ina226-stats.hpp"
+#include "history/ina226-history.hpp"
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "nvs.h"
+#endif
+
+#ifndef CONFIG_INA226_CHECKPOINT_INTERVAL_S
+#define CONFIG_INA226_CHECKPOINT_INTERVAL_S 300
+#endif
+#ifndef CONFIG_INA226_HISTORY_CHECKPOINT_INTERVAL_S
+#define CONFIG_INA226_HISTORY_CHECKPOINT_INTERVAL_S 3600
+#endif
+
+namespace ina226
+{
+    /**
+     * @class Storage
+     * @brief Stockage clé → bloc binaire. Une écriture remplace le bloc entier ; sa
+     *        durabilité est acquise au retour de store().
+     */
+    class Storage
+    {
+    public:
+        virtual ~Storage() = default;
+
+        /// Lit le bloc `key` ; ESP_ERR_NOT_FOUND s'il n'existe pas, ESP_ERR_INVALID_SIZE s'il dépasse `capacity`
+        virtual esp_err_t load(const char *key, void *buf, size_t capacity, size_t &len) = 0;
+        virtual esp_err_t store(const char *key, const void *data, size_t len) = 0;
+
+        /**
+         * Place nécessaire pour `copies` blocs de `len` octets vivants simultanément ;
+         * ESP_ERR_NO_MEM si le support ne peut pas les contenir. Sans limite connue : ESP_OK.
+         */
+        virtual esp_err_t check_capacity(size_t /*len*/, size_t /*copies*/) const { return ESP_OK; }
+    };
+
+#if !CONFIG_IDF_TARGET_LINUX
+    /**
+     * Partition NVS (nvs_flash_init() appelé par l'application) ; clés de 15 caractères au plus.
+     *
+     * NVS écrit la nouvelle copie d'un bloc avant d'effacer l'ancienne et garde une page
+     * libre pour le ramasse-miettes : un Checkpoint de n octets y occupe jusqu'à trois
+     * copies. Suffisant pour les compteurs ; l'image de l'historique (≈ 10 Ko avec les
+     * profondeurs par défaut) demande ≈ 30 Ko, soit une partition d'au moins 36 Ko
+     * (0x9000) avec la page de réserve, en plus des autres utilisateurs de NVS. La
+     * partition "nvs" de 24 Ko des tables par défaut ne suffit pas : partition dédiée
+     * (open(…, partition)) ou FileStorage.
+     */
+    class NvsStorage : public Storage
+    {
+    public:
+        ~NvsStorage() override;
+
+        esp_err_t open(const char *name_space = "ina226", const char *partition = NVS_DEFAULT_PART_NAME);
+        void close();
+
+        esp_err_t load(const char *key, void *buf, size_t capacity, size_t &len) override;
+        esp_err_t store(const char *key, const void *data, size_t len) override;
+        esp_err_t check_capacity(size_t len, size_t copies) const override;
+
+        /// Octets occupés par un bloc de `len` octets (entrées de 32 octets, en-têtes de fragments)
+        static constexpr size_t footprint(size_t len)
+        {
+            return ENTRY_SIZE * ((len + ENTRY_SIZE - 1) / ENTRY_SIZE + 1 + (len + CHUNK_SIZE - 1) / CHUNK_SIZE);
+        }
+
+    private:
+        static constexpr size_t ENTRY_SIZE = 32;
+        static constexpr size_t ENTRIES_PER_PAGE = 126;
+        static constexpr size_t CHUNK_SIZE = (ENTRIES_PER_PAGE - 1) * ENTRY_SIZE;
+
+        nvs_handle_t handle_ = 0;
+        bool open_ = false;
+        char partition_[16] = {};
+    };
+#endif
+
+    /// Un fichier par clé dans un répertoire (VFS : SPIFFS, FAT, ou système hôte sur la cible linux)
+    class FileStorage : public Storage
+    {
+    public:
+        esp_err_t open(const char *directory);
+
+        esp_err_t load(const char *key, void *buf, size_t capacity, size_t &len) override;
+        esp_err_t store(const char *key, const void *data, size_t len) override;
+
+    private:
+        bool path_of(const char *key, char *out, size_t len) const;
+
+        char dir_[64] = {};
+    };
+
+    struct CheckpointStats
+    {
+        uint32_t writes = 0;
+        uint32_t failures = 0;
+        uint32_t corrupt = 0; // emplacements rejetés à la restauration (CRC, longueur, version)
+        uint64_t bytes = 0;
+        TimingStats write_duration;
+    };
+
+    /**
+     * @class Checkpoint
+     * @brief Enregistrement à deux emplacements (<name>.a / <name>.b) avec CRC-32.
+     *
+     * Chaque commit() écrit l'emplacement qui ne contient pas la dernière version valide,
+     * avec un numéro de séquence incrémenté. Une coupure pendant l'écriture ne peut
+     * corrompre que cet emplacement : restore() retient la version valide la plus récente,
+     * l'autre emplacement conservant la précédente.
+     *
+     * La charge utile est composée directement dans le tampon fourni (payload()), sans copie.
+     */
+    class Checkpoint
+    {
+    public:
+        static constexpr size_t HEADER_SIZE = 20;
+
+        /// @param name 12 caractères au plus (clés NVS limitées à 15)
+        Checkpoint(Storage &storage, const char *name, uint8_t *scratch, size_t capacity, uint16_t version = 1);
+
+        uint8_t *payload() { return buf_ + HEADER_SIZE; }
+        const uint8_t *payload() const { return buf_ + HEADER_SIZE; }
+        size_t payload_capacity() const { return capacity_ > HEADER_SIZE ? capacity_ - HEADER_SIZE : 0; }
+
+        /// Scelle les `len` premiers octets de payload() et les écrit dans l'emplacement libre
+        esp_err_t commit(size_t len);
+
+        /// Recharge la version valide la plus récente dans payload() ; ESP_ERR_NOT_FOUND si aucune
+        esp_err_t restore(size_t &len);
+
+        uint32_t sequence() const { return sequence_; }
+        const CheckpointStats &stats() const { return stats_; }
+
+    private:
+        /// Lit un emplacement dans le tampon ; vrai si valide, séquence dans `seq`
+        bool read_slot(int slot, size_t &len, uint32_t &seq);
+
+        Storage &storage_;
+        uint8_t *buf_;
+        size_t capacity_;
+        uint16_t version_;
+        char keys_[2][16];
+        uint32_t sequence_ = 0;
+        int next_slot_ = 0;
+        CheckpointStats stats_;
+    };
+
+    /// Compteurs cumulés d'un démarrage à l'autre
+    struct EnergyTotals
+    {
+        double energy_mj = 0.0;
+        double charge_mc = 0.0; // intégrale du courant signé (mA·s)
+        uint64_t samples = 0;
+        int64_t runtime_us = 0; // durée d'acquisition intégrée (hors écarts > max_gap_s)
+        uint32_t boots = 0;     // restaurations réussies
+    };
+
+    struct PersistPolicy
+    {
+        uint32_t totals_interval_s = 300;   // 0 : flush() seul
+        uint32_t history_interval_s = 3600; // 0 : flush() seul
+        uint32_t max_gap_s = 60;            // écart entre mesures au-delà duquel rien n'est intégré
+
+        static PersistPolicy from_kconfig();
+    };
+
+    struct PersistStats
+    {
+        uint32_t totals_writes = 0;
+        uint32_t history_writes = 0;
+        uint32_t failures = 0;
+        uint32_t corrupt = 0;
+        uint64_t bytes = 0;
+        /// Plus grande énergie accumulée entre deux sauvegardes : perte maximale sur coupure
+        double max_unsaved_energy_mj = 0.0;
+        TimingStats write_duration;
+
+        /// Écritures par jour au rythme observé (usure de la flash)
+        float writes_per_day(int64_t elapsed_us) const;
+
+        void log() const;
+        std::string to_json() const;
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 256;
+    };
+
+    /**
+     * @class StatePersistence
+     * @brief Sauvegarde périodique des compteurs d'énergie et de l'historique.
+     *
+     * add() ne fait que cumuler en RAM ; poll() écrit les compteurs toutes les
+     * totals_interval_s et l'historique toutes les history_interval_s, chacun dans son
+     * Checkpoint. L'intervalle borne à la fois l'usure (86400 / intervalle écritures par
+     * jour et par enregistrement) et l'énergie perdue sur coupure, mesurée par
+     * unsaved_energy_mj() et PersistStats::max_unsaved_energy_mj.
+     *
+     * Alimenté par la tâche de traitement (INA226Manager::attach_persistence) ; les
+     * écritures NVS (effacement de page compris) ont lieu dans cette tâche.
+     *
+     * Les compteurs tiennent dans NVS ; l'historique va de préférence sur un système de
+     * fichiers (second constructeur). restore() vérifie que le support de l'historique
+     * peut contenir ses deux emplacements plus la copie en cours d'écriture ; sinon
+     * l'historique n'est ni restauré ni sauvegardé (history_enabled()).
+     */
+    class StatePersistence
+    {
+    public:
+        /// Tampon suffisant pour les compteurs et, si `with_history`, l'image de l'historique
+        static constexpr size_t scratch_size(bool with_history)
+        {
+            return Checkpoint::HEADER_SIZE + (with_history ? HistoryStore::SNAPSHOT_SIZE : sizeof(EnergyTotals));
+        }
+
+        StatePersistence(Storage &storage, uint8_t *scratch, size_t capacity,
+                         const PersistPolicy &policy = PersistPolicy::from_kconfig());
+
+        /// Compteurs sur `totals_storage` (NVS), historique sur `history_storage` (FileStorage)
+        StatePersistence(Storage &totals_storage, Storage &history_storage, uint8_t *scratch, size_t capacity,
+                         const PersistPolicy &policy = PersistPolicy::from_kconfig());
+
+        /// Sauvegarde aussi cet historique (avant restore())
+        void attach_history(HistoryStore *history) { history_ = history; }
+
+        /**
+         * Recharge compteurs et historique au démarrage ; ESP_ERR_NOT_FOUND au premier démarrage.
+         * Désactive la sauvegarde de l'historique si son support est trop petit.
+         */
+        esp_err_t restore();
+
+        /// Historique attaché et sauvegardé (support de taille suffisante)
+        bool history_enabled() const { return history_ && history_fits_; }
+
+        void add(const Measurement &m);
+
+        /// Écrit ce dont l'intervalle est écoulé
+        esp_err_t poll(int64_t now_us);
+
+        /// Écrit immédiatement compteurs et historique (arrêt volontaire, mise en veille)
+        esp_err_t flush();
+
+        const EnergyTotals &totals() const { return totals_; }
+        double unsaved_energy_mj() const { return totals_.energy_mj - saved_energy_mj_; }
+        const PersistStats &stats() const { return stats_; }
+
+    private:
+        esp_err_t save_totals(int64_t now_us);
+        esp_err_t save_history(int64_t now_us);
+        void account(esp_err_t err, int64_t start_us);
+
+        Storage &history_storage_;
+        Checkpoint totals_cp_;
+        Checkpoint history_cp_;
+        bool history_fits_ = true;
+        HistoryStore *history_ = nullptr;
+        PersistPolicy policy_;
+        PersistStats stats_;
+
+        EnergyTotals totals_;
+        double saved_energy_mj_ = 0.0;
+        int64_t last_us_ = 0;
+        float last_mw_ = 0.0f;
+        float last_ma_ = 0.0f;
+        bool has_last_ = false;
+        int64_t totals_saved_us_ = 0;
+        int64_t history_saved_us_ = 0;
+        bool dirty_ = false;
+    };
+
+} // namespace ina226
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "esp_err.h"
+
+#include "ina226-common_types.hpp"
+#include "profile/ina226-quantile.hpp"
+
+namespace ina226
+{
+    /**
+     * @class LoadProfile
+     * @brief Profil de charge long terme : quantiles du courant et de la puissance.
+     *
+     * Alimenté par la tâche de traitement (INA226Manager::attach_profile) à chaque
+     * échantillon. À la fin de chaque période de rapport, le rappel reçoit le profil de la
+     * période (à encoder ou fusionner dans un cumul) puis les sketchs sont remis à zéro.
+     * Mémoire fixe (~9 Ko), indépendante de la durée et de la cadence.
+     */
+    class LoadProfile
+    {
+    public:
+        /// Courant signé, 2^-8 mA .. 2^16 mA (65 A)
+        using CurrentSketch = QuantileSketch<-8, 16, 5, true>;
+        /// Puissance, 2^-6 mW .. 2^18 mW (262 W)
+        using PowerSketch = QuantileSketch<-6, 18, 5, false>;
+
+        /// Appelé dans la tâche de traitement en fin de période, avant remise à zéro
+        using ReportCallback = void (*)(const LoadProfile &profile, void *ctx);
+
+        /// Quantiles rapportés par log() et to_json()
+        static constexpr double QUANTILES[] = {0.5, 0.95, 0.99, 0.999};
+        static constexpr size_t QUANTILE_COUNT = sizeof(QUANTILES) / sizeof(QUANTILES[0]);
+
+        /// @param period_s durée d'une période de rapport ; 0 : cumul sans fin de période
+        explicit LoadProfile(uint32_t period_s = 3600, ReportCallback cb = nullptr, void *ctx = nullptr);
+
+        void add(const Measurement &m);
+
+        /// Termine la période en cours (rappel puis remise à zéro) ; sans effet si vide
+        void close_period(int64_t now_us);
+
+        /// Fusionne un autre profil (autre composant, période précédente)
+        void merge(const LoadProfile &other);
+
+        /// Fusionne un profil sérialisé par encode()
+        esp_err_t merge_encoded(const uint8_t *buf, size_t len);
+
+        /// Sérialise les deux sketchs ; retourne la longueur écrite, 0 si `len` est insuffisant
+        size_t encode(uint8_t *buf, size_t len) const;
+        static constexpr size_t MAX_ENCODED_SIZE = 24 + CurrentSketch::MAX_ENCODED_SIZE + PowerSketch::MAX_ENCODED_SIZE;
+
+        const CurrentSketch &current() const { return current_; }
+        const PowerSketch &power() const { return power_; }
+        int64_t start_us() const { return start_us_; }
+        int64_t end_us() const { return end_us_; }
+
+        void reset();
+
+        void log() const;
+        std::string to_json() const;
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 384;
+
+    private:
+        CurrentSketch current_;
+        PowerSketch power_;
+        int64_t start_us_ = 0;
+        int64_t end_us_ = 0;
+
+        int64_t period_us_;
+        ReportCallback cb_;
+        void *ctx_;
+
+        inline static const char *TAG = "INA226-PROFILE";
+    };
+
+} // namespace ina226
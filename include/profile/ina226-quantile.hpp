@@ -0,0 +1,402 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "esp_err.h"
+
+namespace ina226
+{
+    /**
+     * @class QuantileSketch
+     * @brief Estimateur de quantiles en flux, mémoire fixe, fusionnable sans perte.
+     *
+     * Histogramme log-linéaire : chaque octave [2^e, 2^(e+1)) de |v| est découpée en
+     * 2^SubBits classes égales. L'indice se lit directement dans la représentation IEEE 754
+     * (exposant et SubBits bits de poids fort de la mantisse) : un décalage et une
+     * soustraction par échantillon, sans logarithme. L'erreur relative d'un quantile est
+     * bornée par 2^-(SubBits+1) (1,6 % pour SubBits = 5), quelle que soit la durée.
+     *
+     * |v| < 2^MinExp compte comme zéro ; |v| ≥ 2^MaxExp est rangé dans la dernière classe
+     * (overflow()). Deux sketchs de même type se fusionnent par simple addition des
+     * compteurs : le résultat est identique à celui d'un sketch unique alimenté par les
+     * deux flux. encode()/merge_encoded() transportent un sketch entre composants ou
+     * périodes de rapport (classes non vides seules, entiers variables).
+     *
+     * Les classes restent sur 32 bits (mémoire du sketch) : add() et merge() saturent une
+     * classe à UINT32_MAX plutôt que de reboucler, merge_encoded() refuse un message qui la
+     * ferait déborder. count() et les autres compteurs sont sur 64 bits.
+     */
+    template <int MinExp, int MaxExp, unsigned SubBits = 5, bool Signed = true>
+    class QuantileSketch
+    {
+        static_assert(MinExp < MaxExp && MinExp >= -126 && MaxExp <= 127, "plage d'exposants hors float");
+        static_assert(SubBits >= 1 && SubBits <= 10, "SubBits entre 1 et 10");
+
+    public:
+        static constexpr uint32_t SUB_BINS = 1u << SubBits;
+        static constexpr uint32_t BINS = static_cast<uint32_t>(MaxExp - MinExp) * SUB_BINS; // par signe
+        static constexpr float RELATIVE_ERROR = 1.0f / (2 * SUB_BINS);
+        /// Taille maximale de encode() : en-tête + (écart, compteur) par classe
+        static constexpr size_t MAX_ENCODED_SIZE = 48 + (Signed ? 2 : 1) * BINS * 8;
+
+        void add(float v)
+        {
+            if (std::isnan(v))
+                return;
+            ++count_;
+            sum_ += v;
+            if (v < min_)
+                min_ = v;
+            if (v > max_)
+                max_ = v;
+
+            const bool negative = v < 0.0f;
+            uint32_t bits;
+            const float mag = std::fabs(v);
+            std::memcpy(&bits, &mag, sizeof(bits));
+            const uint32_t key = bits >> (23 - SubBits);
+            if (key < BASE_KEY || (negative && !Signed))
+            {
+                ++zero_;
+                return;
+            }
+            uint32_t i = key - BASE_KEY;
+            if (i >= BINS)
+            {
+                i = BINS - 1;
+                ++overflow_;
+            }
+            uint32_t &bin = negative ? neg_[Signed ? i : 0] : pos_[i];
+            if (bin != UINT32_MAX)
+                ++bin;
+        }
+
+        /// Quantile q ∈ [0, 1] (rang ⌊q × (n − 1)⌋) ; 0 si vide
+        float quantile(double q) const
+        {
+            if (count_ == 0)
+                return 0.0f;
+            q = q < 0.0 ? 0.0 : (q > 1.0 ? 1.0 : q);
+            const uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count_ - 1));
+
+            uint64_t seen = 0;
+            float v = max_;
+            bool found = false;
+            if constexpr (Signed)
+            {
+                for (uint32_t i = BINS; i-- > 0 && !found;)
+                {
+                    seen += neg_[i];
+                    if (seen > rank)
+                    {
+                        v = -bin_value(i);
+                        found = true;
+                    }
+                }
+            }
+            if (!found)
+            {
+                seen += zero_;
+                if (seen > rank)
+                {
+                    v = 0.0f;
+                    found = true;
+                }
+            }
+            for (uint32_t i = 0; i < BINS && !found; ++i)
+            {
+                seen += pos_[i];
+                if (seen > rank)
+                {
+                    v = bin_value(i);
+                    found = true;
+                }
+            }
+            // Les extrêmes exacts bornent l'estimation
+            return v < min_ ? min_ : (v > max_ ? max_ : v);
+        }
+
+        void merge(const QuantileSketch &other)
+        {
+            for (uint32_t i = 0; i < BINS; ++i)
+                pos_[i] = saturating_add(pos_[i], other.pos_[i]);
+            if constexpr (Signed)
+                for (uint32_t i = 0; i < BINS; ++i)
+                    neg_[i] = saturating_add(neg_[i], other.neg_[i]);
+            zero_ += other.zero_;
+            overflow_ += other.overflow_;
+            count_ += other.count_;
+            sum_ += other.sum_;
+            if (other.min_ < min_)
+                min_ = other.min_;
+            if (other.max_ > max_)
+                max_ = other.max_;
+        }
+
+        /// Sérialise le sketch ; retourne la longueur écrite, 0 si `len` est insuffisant
+        size_t encode(uint8_t *buf, size_t len) const
+        {
+            Writer w{buf, len};
+            w.byte(MAGIC[0]);
+            w.byte(MAGIC[1]);
+            w.byte(VERSION);
+            w.byte(SubBits);
+            w.byte(static_cast<uint8_t>(static_cast<int8_t>(MinExp)));
+            w.byte(static_cast<uint8_t>(static_cast<int8_t>(MaxExp)));
+            w.byte(Signed);
+            w.varint(count_);
+            w.varint(zero_);
+            w.varint(overflow_);
+            w.raw(&min_, sizeof(min_));
+            w.raw(&max_, sizeof(max_));
+            w.raw(&sum_, sizeof(sum_));
+            encode_bins(w, pos_);
+            if constexpr (Signed)
+                encode_bins(w, neg_);
+            return w.ok ? w.pos : 0;
+        }
+
+        /**
+         * Fusionne un sketch sérialisé par encode() d'un type identique.
+         * Le sketch n'est modifié que si le message est entièrement valide.
+         * @return ESP_ERR_INVALID_STATE si un compteur du sketch déborderait
+         */
+        esp_err_t merge_encoded(const uint8_t *buf, size_t len)
+        {
+            esp_err_t err = check_encoded(buf, len);
+            if (err != ESP_OK)
+                return err;
+            return decode(buf, len, nullptr, this);
+        }
+
+        /// Vérifie qu'un message encode() est fusionnable dans ce sketch (format et débordements)
+        esp_err_t check_encoded(const uint8_t *buf, size_t len) const { return decode(buf, len, this, nullptr); }
+
+        /// Vérifie le format d'un message encode() sans le fusionner
+        static esp_err_t validate_encoded(const uint8_t *buf, size_t len) { return decode(buf, len, nullptr, nullptr); }
+
+        /// Remise à zéro en place (pas de temporaire de la taille du sketch sur la pile)
+        void reset()
+        {
+            std::memset(pos_, 0, sizeof(pos_));
+            std::memset(neg_, 0, sizeof(neg_));
+            zero_ = overflow_ = count_ = 0;
+            sum_ = 0.0;
+            min_ = INFINITY;
+            max_ = -INFINITY;
+        }
+
+        uint64_t count() const { return count_; }
+        uint64_t overflow() const { return overflow_; }
+        float min() const { return count_ ? min_ : 0.0f; }
+        float max() const { return count_ ? max_ : 0.0f; }
+        double mean() const { return count_ ? sum_ / count_ : 0.0; }
+
+    private:
+        static constexpr uint32_t BASE_KEY = static_cast<uint32_t>(MinExp + 127) << SubBits;
+        static constexpr uint8_t MAGIC[2] = {'Q', 'S'};
+        static constexpr uint8_t VERSION = 1;
+
+        static uint32_t saturating_add(uint32_t a, uint32_t b) { return b > UINT32_MAX - a ? UINT32_MAX : a + b; }
+
+        /// Milieu de la classe i (valeur absolue)
+        static float bin_value(uint32_t i)
+        {
+            const uint32_t lo_bits = (BASE_KEY + i) << (23 - SubBits);
+            const uint32_t hi_bits = (BASE_KEY + i + 1) << (23 - SubBits);
+            float lo, hi;
+            std::memcpy(&lo, &lo_bits, sizeof(lo));
+            std::memcpy(&hi, &hi_bits, sizeof(hi));
+            return 0.5f * (lo + hi);
+        }
+
+        struct Writer
+        {
+            uint8_t *buf;
+            size_t len;
+            size_t pos = 0;
+            bool ok = true;
+
+            void byte(uint8_t b)
+            {
+                if (pos < len)
+                    buf[pos++] = b;
+                else
+                    ok = false;
+            }
+            void varint(uint64_t v)
+            {
+                while (v >= 0x80)
+                {
+                    byte(static_cast<uint8_t>(v) | 0x80);
+                    v >>= 7;
+                }
+                byte(static_cast<uint8_t>(v));
+            }
+            void raw(const void *p, size_t n)
+            {
+                const auto *b = static_cast<const uint8_t *>(p);
+                for (size_t i = 0; i < n; ++i)
+                    byte(b[i]);
+            }
+        };
+
+        struct Reader
+        {
+            const uint8_t *buf;
+            size_t len;
+            size_t pos = 0;
+            bool ok = true;
+
+            uint8_t byte()
+            {
+                if (pos < len)
+                    return buf[pos++];
+                ok = false;
+                return 0;
+            }
+            uint64_t varint()
+            {
+                uint64_t v = 0;
+                for (unsigned shift = 0; shift < 64 && ok; shift += 7)
+                {
+                    const uint8_t b = byte();
+                    v |= static_cast<uint64_t>(b & 0x7F) << shift;
+                    if (!(b & 0x80))
+                        return v;
+                }
+                ok = false;
+                return 0;
+            }
+            void raw(void *p, size_t n)
+            {
+                auto *b = static_cast<uint8_t *>(p);
+                for (size_t i = 0; i < n; ++i)
+                    b[i] = byte();
+            }
+        };
+
+        static void encode_bins(Writer &w, const uint32_t *bins)
+        {
+            uint32_t used = 0;
+            for (uint32_t i = 0; i < BINS; ++i)
+                used += bins[i] != 0;
+            w.varint(used);
+            uint32_t prev = 0;
+            for (uint32_t i = 0; i < BINS; ++i)
+            {
+                if (!bins[i])
+                    continue;
+                w.varint(i - prev);
+                w.varint(bins[i]);
+                prev = i;
+            }
+        }
+
+        enum class BinsResult
+        {
+            Ok,
+            Invalid,
+            Overflow,
+        };
+
+        /**
+         * Classes lues contrôlées contre `current` (non nul) : Overflow si une somme dépasserait
+         * UINT32_MAX. Compteurs ajoutés à `into` (non nul), après un contrôle réussi.
+         */
+        static BinsResult decode_bins(Reader &r, const uint32_t *current, uint32_t *into)
+        {
+            const uint64_t used = r.varint();
+            if (used > BINS)
+                return BinsResult::Invalid;
+            uint64_t i = 0;
+            for (uint64_t n = 0; n < used && r.ok; ++n)
+            {
+                const uint64_t gap = r.varint();
+                const uint64_t c = r.varint();
+                i += gap;
+                // Indices strictement croissants : une classe n'est comptée qu'une fois
+                if ((n && !gap) || i >= BINS || c > UINT32_MAX)
+                    return BinsResult::Invalid;
+                if (current && c > UINT32_MAX - current[i])
+                    return BinsResult::Overflow;
+                if (into)
+                    into[i] += static_cast<uint32_t>(c);
+            }
+            return r.ok ? BinsResult::Ok : BinsResult::Invalid;
+        }
+
+        static esp_err_t to_error(BinsResult res, const Reader &r)
+        {
+            if (res == BinsResult::Overflow)
+                return ESP_ERR_INVALID_STATE;
+            return r.ok ? ESP_ERR_INVALID_ARG : ESP_ERR_INVALID_SIZE;
+        }
+
+        static bool add_overflows(uint64_t a, uint64_t b) { return b > UINT64_MAX - a; }
+
+        /// `target` : sketch contrôlé contre le débordement ; `into` : sketch alimenté (déjà contrôlé)
+        static esp_err_t decode(const uint8_t *buf, size_t len, const QuantileSketch *target, QuantileSketch *into)
+        {
+            Reader r{buf, len};
+            if (r.byte() != MAGIC[0] || r.byte() != MAGIC[1])
+                return ESP_ERR_INVALID_ARG;
+            if (r.byte() != VERSION)
+                return ESP_ERR_INVALID_VERSION;
+            // Paramètres différents : classes incompatibles
+            if (r.byte() != SubBits || static_cast<int8_t>(r.byte()) != MinExp ||
+                static_cast<int8_t>(r.byte()) != MaxExp || r.byte() != Signed)
+                return ESP_ERR_INVALID_ARG;
+
+            const uint64_t count = r.varint();
+            const uint64_t zero = r.varint();
+            const uint64_t overflow = r.varint();
+            float mn, mx;
+            double sum;
+            r.raw(&mn, sizeof(mn));
+            r.raw(&mx, sizeof(mx));
+            r.raw(&sum, sizeof(sum));
+            if (!r.ok)
+                return ESP_ERR_INVALID_SIZE;
+            if (target && (add_overflows(target->count_, count) || add_overflows(target->zero_, zero) ||
+                           add_overflows(target->overflow_, overflow)))
+                return ESP_ERR_INVALID_STATE;
+
+            BinsResult res = decode_bins(r, target ? target->pos_ : nullptr, into ? into->pos_ : nullptr);
+            if (res != BinsResult::Ok)
+                return to_error(res, r);
+            if constexpr (Signed)
+            {
+                res = decode_bins(r, target ? target->neg_ : nullptr, into ? into->neg_ : nullptr);
+                if (res != BinsResult::Ok)
+                    return to_error(res, r);
+            }
+
+            if (into)
+            {
+                into->count_ += count;
+                into->zero_ += zero;
+                into->overflow_ += overflow;
+                into->sum_ += sum;
+                if (count && mn < into->min_)
+                    into->min_ = mn;
+                if (count && mx > into->max_)
+                    into->max_ = mx;
+            }
+            return ESP_OK;
+        }
+
+        uint32_t pos_[BINS] = {};
+        uint32_t neg_[Signed ? BINS : 1] = {};
+        uint64_t zero_ = 0;
+        uint64_t overflow_ = 0;
+        uint64_t count_ = 0;
+        double sum_ = 0.0;
+        float min_ = INFINITY;
+        float max_ = -INFINITY;
+    };
+
+} // namespace ina226
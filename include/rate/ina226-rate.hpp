@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ina226-stats.hpp"
+#include "config/ina226-config_types.hpp"
+
+namespace ina226
+{
+    /// Débit d'acquisition réel face au débit théorique de la configuration
+    struct RateStats
+    {
+        uint32_t expected_period_us = 0; // 0 : pas de cadence attendue (déclenché, CNVR inactif)
+        uint32_t fresh = 0;      // lectures avec CVRF levé : nouvelle conversion
+        uint32_t duplicated = 0; // lectures sans CVRF : même conversion relue
+        uint32_t missed = 0;     // conversions écrasées avant d'avoir été lues
+        TimingStats fresh_interval; // entre deux lectures de conversions nouvelles
+        TimingStats read_duration;  // durée d'une acquisition complète (0x06 + 0x01..0x04)
+        int64_t first_us = 0;
+        int64_t last_us = 0;
+
+        /// Conversions lues par seconde sur la fenêtre observée
+        float achieved_sps() const;
+        /// Conversions produites par seconde selon la configuration
+        float theoretical_sps() const;
+        /// Part des conversions produites effectivement lues (1 : aucune perdue)
+        float efficiency() const;
+        /// Part de la période de conversion occupée par le bus (dimensionnement I2C)
+        float bus_utilization() const;
+
+        void log() const;
+        std::string to_json() const;
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 256;
+    };
+
+    /**
+     * @class RateMonitor
+     * @brief Comptabilité des conversions lues, relues et perdues d'un composant.
+     *
+     * Chaque acquisition rapporte la valeur lue de Mask/Enable (0x06) : CVRF levé signale une
+     * conversion terminée depuis la lecture précédente, CVRF absent une relecture du même
+     * résultat. Les conversions perdues se déduisent de l'intervalle entre deux lectures
+     * fraîches, arrondi au nombre de périodes attendues. Toute autre lecture de 0x06
+     * (get_status(), reprise de santé) acquitte CVRF et compte une relecture à la suivante.
+     */
+    class RateMonitor
+    {
+    public:
+        /// Période attendue entre deux conversions : mode continu et CNVR actif, sinon 0
+        static uint32_t expected_period_us(const ConfigParams &params);
+
+        /// (Re)démarre la comptabilité sur une configuration ; les compteurs sont conservés
+        void configure(const ConfigParams &params);
+
+        /**
+         * @param retries conversions terminées pendant la lecture et relues aussitôt
+         *                (CTRL::get_coherent) : fraîches, sans intervalle mesurable
+         */
+        void on_sample(int64_t read_us, uint16_t mask_enable, int64_t read_duration_us, uint8_t retries = 0);
+
+        void reset();
+
+        const RateStats &stats() const { return stats_; }
+        void log() const { stats_.log(); }
+
+    private:
+        RateStats stats_;
+        int64_t last_fresh_us_ = 0;
+    };
+
+} // namespace ina226
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "esp_err.h"
+
+#include "ina226-common_types.hpp"
+#include "capture/ina226-capture.hpp"
+
+namespace ina226
+{
+    /**
+     * @class ReplayBus
+     * @brief Simulation registre par registre d'un INA226 alimentée par une capture enregistrée.
+     *
+     * Expose la même interface read/write qu'I2CDevices. Chaque step() charge l'échantillon
+     * suivant dans les registres 0x01..0x04, lève CVRF et, comme le composant, active la
+     * broche ALERT si CNVR est activé ou si la fonction d'alerte configurée est dépassée.
+     * La broche est relâchée à la lecture de 0x06 (ou à l'écriture de 0x00).
+     *
+     * Sur la cible "linux", le rejeu fournit aussi l'horloge des échantillons
+     * (ina226::clock) : le pilote date les mesures avec le temps enregistré, quelle que
+     * soit la vitesse de run(). Historique, persistance, cadence et surveillance voient
+     * ainsi la chronologie d'origine, y compris en rejeu accéléré ou sans attente.
+     */
+    class ReplayBus
+    {
+    public:
+        /// Appelé à chaque front actif de la broche ALERT simulée (contexte de la tâche de rejeu)
+        using EdgeCallback = void (*)(void *ctx);
+
+        ReplayBus() = default;
+        ~ReplayBus();
+
+        ReplayBus(const ReplayBus &) = delete;
+        ReplayBus &operator=(const ReplayBus &) = delete;
+
+        /// Source mémoire : `samples` doit rester valide pendant le rejeu
+        void load(const RawSample *samples, size_t count, uint16_t calibration_raw = 0);
+#if CONFIG_IDF_TARGET_LINUX
+        /// Source capture : les registres de configuration sont restaurés depuis l'en-tête
+        void load(const CaptureReader &reader);
+#endif
+
+        void set_edge_callback(EdgeCallback cb, void *ctx);
+
+        /**
+         * Fournit (par défaut) ou non l'horloge des échantillons à partir du prochain load().
+         * Le dernier rejeu chargé l'emporte ; sa destruction rend l'horloge à esp_timer.
+         */
+        void drive_clock(bool enable) { drive_clock_ = enable; }
+
+        /**
+         * Temps virtuel : horodatage enregistré de l'échantillon courant, avancé jusqu'au
+         * suivant au rythme de run() (`speed` × temps réel) ; figé sans attente ou en step().
+         */
+        int64_t virtual_time_us() const;
+
+        // === Interface I2CDevices ===
+        esp_err_t read(uint8_t reg, uint8_t *data, size_t len);
+        esp_err_t write(uint8_t reg, const uint8_t *data, size_t len);
+
+        /// Charge l'échantillon suivant ; false en fin de capture
+        bool step();
+
+        /**
+         * Rejoue toute la capture.
+         * @param speed     1.0 = cadence d'origine, 10.0 = 10× plus vite, <= 0 = sans attente
+         * @param lockstep  attend que le pilote ait lu l'échantillon courant avant le suivant,
+         *                  ce qui rend le rejeu déterministe quelle que soit la vitesse
+         * @param timeout_ms attente maximale du pilote en lockstep avant de compter une perte
+         */
+        void run(float speed = 1.0f, bool lockstep = true, uint32_t timeout_ms = 1000);
+
+        /// Horodatage enregistré de l'échantillon courant
+        int64_t now_us() const { return current_.timestamp_us; }
+
+        bool alert_asserted() const { return alert_pin_; }
+        uint32_t replayed() const { return replayed_; }
+        uint32_t dropped() const { return dropped_; }
+        uint32_t edges() const { return edges_; }
+
+    private:
+        static constexpr uint16_t DEFAULT_CONFIG = 0x4127;
+        static constexpr uint16_t MANUFACTURER_ID = reg::ManufacturerId::TI;
+        static constexpr uint16_t DIE_ID = 0x2260;
+        static constexpr uint8_t RESULT_REGS_MASK = 0x1E; // 0x01..0x04
+
+        bool fetch(RawSample &out);
+        /// Origine de l'horloge virtuelle (premier enregistrement) et prise de l'horloge
+        void start_clock(int64_t first_us);
+        static int64_t clock_thunk(void *ctx);
+        void apply(const RawSample &sample);
+        bool evaluate_alert_function() const;
+
+        mutable std::mutex mutex_;
+        std::condition_variable consumed_cv_;
+
+        const RawSample *samples_ = nullptr;
+        size_t count_ = 0;
+        size_t next_ = 0;
+#if CONFIG_IDF_TARGET_LINUX
+        const CaptureReader *reader_ = nullptr;
+        CapturePosition pos_{};
+#endif
+
+        RawSample current_{};
+        uint16_t regs_[8] = {DEFAULT_CONFIG, 0, 0, 0, 0, 0, 0, 0};
+        uint8_t read_mask_ = RESULT_REGS_MASK;
+        bool alert_pin_ = false;
+
+        EdgeCallback edge_cb_ = nullptr;
+        void *edge_ctx_ = nullptr;
+
+        // Horloge virtuelle : base + (réel − ancre) × vitesse, bornée à l'échantillon suivant
+        mutable std::mutex clock_mutex_;
+        int64_t clock_base_us_ = 0;
+        int64_t clock_limit_us_ = 0;
+        std::chrono::steady_clock::time_point clock_anchor_{};
+        float clock_speed_ = 0.0f;
+        bool drive_clock_ = true;
+        inline static std::atomic<ReplayBus *> s_clock_owner{nullptr};
+
+        uint32_t replayed_ = 0;
+        uint32_t dropped_ = 0;
+        uint32_t edges_ = 0;
+
+        inline static const char *TAG = "INA226-REPLAY";
+    };
+
+} // namespace ina226
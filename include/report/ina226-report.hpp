@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ina226-common_types.hpp"
+
+namespace ina226
+{
+    enum class ReportChannel : uint8_t
+    {
+        Shunt,
+        Bus,
+        Current,
+        Power,
+        Count
+    };
+
+    /**
+     * Bande morte d'une voie : écart au dernier échantillon émis au-delà duquel la voie
+     * déclenche une émission. Seuil = max(absolute, relative × |dernière valeur émise|) :
+     * la part absolue tient lieu de plancher près de zéro, où un seuil relatif seul
+     * laisserait passer le bruit.
+     */
+    struct Deadband
+    {
+        float absolute = INFINITY;
+        float relative = 0.0f;
+
+        /// Voie ignorée (valeur par défaut)
+        static constexpr Deadband off() { return {INFINITY, 0.0f}; }
+
+        bool exceeded(float reference, float value) const
+        {
+            const float threshold = std::fmax(absolute, relative * std::fabs(reference));
+            return std::fabs(value - reference) > threshold;
+        }
+    };
+
+    /// Politique d'émission par exception
+    struct ReportPolicy
+    {
+        Deadband shunt_uv = Deadband::off();
+        Deadband bus_mv = {10.0f, 0.005f};     // 10 mV ou 0,5 %
+        Deadband current_ma = {1.0f, 0.01f};   // 1 mA ou 1 %
+        Deadband power_mw = Deadband::off();   // suit courant et tension
+        uint32_t max_silence_ms = 10000;       // émission forcée après ce délai ; 0 : jamais
+
+        const Deadband &channel(ReportChannel c) const;
+    };
+
+    struct ReportStats
+    {
+        uint32_t evaluated = 0;
+        uint32_t reported = 0;
+        uint32_t suppressed = 0;
+        uint32_t heartbeats = 0; // émissions dues à max_silence_ms seul
+        uint32_t triggers[static_cast<size_t>(ReportChannel::Count)] = {}; // voies ayant franchi leur bande
+
+        /// Part des échantillons émis (1 : aucun filtrage)
+        float ratio() const { return evaluated ? static_cast<float>(reported) / evaluated : 0.0f; }
+
+        void log() const;
+        std::string to_json() const;
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 192;
+    };
+
+    /**
+     * @class ReportFilter
+     * @brief Émission par exception : un échantillon n'est émis que si une voie s'écarte du
+     *        dernier échantillon émis de plus que sa bande morte, ou si max_silence_ms s'est
+     *        écoulé depuis la dernière émission.
+     *
+     * La référence est le dernier échantillon émis et non le précédent : une dérive lente
+     * finit par franchir la bande. Un seul appelant (tâche de traitement ou boucle de
+     * scrutation) ; la politique peut être remplacée entre deux appels.
+     */
+    class ReportFilter
+    {
+    public:
+        explicit ReportFilter(const ReportPolicy &policy = {}) : policy_(policy) {}
+
+        /// Vrai si `m` doit être émis ; `m` devient alors la référence
+        bool accept(const Measurement &m);
+
+        /// La prochaine mesure sera émise quelle qu'elle soit
+        void force_next() { has_reference_ = false; }
+
+        void set_policy(const ReportPolicy &policy) { policy_ = policy; }
+        const ReportPolicy &policy() const { return policy_; }
+
+        const ReportStats &stats() const { return stats_; }
+        void reset_stats() { stats_ = {}; }
+
+    private:
+        ReportPolicy policy_;
+        ReportStats stats_;
+        Measurement reference_;
+        bool has_reference_ = false;
+    };
+
+} // namespace ina226
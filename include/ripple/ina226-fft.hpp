@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace ina226
+{
+    /**
+     * @class FixedFft
+     * @brief FFT complexe radix-2 en virgule fixe Q15, en place, tables précalculées.
+     *
+     * Virgule flottante par bloc : avant chaque étage, tout le bloc est divisé par deux
+     * tant que son maximum pourrait déborder (|a ± w·b| ≤ (1 + √2) max). Le résultat vaut
+     * (re + j·im) × 2^exposant, exposant retourné par forward(). Un signal faible n'est
+     * donc pas écrasé par la mise à l'échelle systématique 1/N d'une FFT Q15 classique.
+     *
+     * Multiplications 16 × 16 → 32 bits uniquement : adapté aux cœurs sans FPU rapide.
+     */
+    template <size_t N>
+    class FixedFft
+    {
+        static_assert(N >= 8 && (N & (N - 1)) == 0, "N doit être une puissance de 2 ≥ 8");
+
+    public:
+        static constexpr size_t SIZE = N;
+        /// Plus grande amplitude d'entrée d'un étage sans débordement : 32767 / (1 + √2)
+        static constexpr int16_t STAGE_LIMIT = 13572;
+
+        FixedFft()
+        {
+            const double step = 2.0 * M_PI / N;
+            for (size_t k = 0; k < N / 2; ++k)
+            {
+                cos_[k] = q15(std::cos(step * k));
+                sin_[k] = q15(std::sin(step * k));
+            }
+            // Fenêtre de Hann périodique
+            for (size_t n = 0; n < N; ++n)
+                window_[n] = q15(0.5 - 0.5 * std::cos(step * n));
+        }
+
+        /// Transformée directe en place ; retourne l'exposant du bloc
+        int forward(int16_t *re, int16_t *im) const
+        {
+            // Permutation bit-reverse
+            for (size_t i = 1, j = 0; i < N; ++i)
+            {
+                size_t bit = N >> 1;
+                for (; j & bit; bit >>= 1)
+                    j ^= bit;
+                j |= bit;
+                if (i < j)
+                {
+                    swap(re[i], re[j]);
+                    swap(im[i], im[j]);
+                }
+            }
+
+            int exponent = 0;
+            for (size_t len = 2; len <= N; len <<= 1)
+            {
+                int32_t peak = 0;
+                for (size_t i = 0; i < N; ++i)
+                {
+                    const int32_t a = re[i] < 0 ? -re[i] : re[i];
+                    const int32_t b = im[i] < 0 ? -im[i] : im[i];
+                    peak = a > peak ? a : peak;
+                    peak = b > peak ? b : peak;
+                }
+                while (peak > STAGE_LIMIT)
+                {
+                    for (size_t i = 0; i < N; ++i)
+                    {
+                        re[i] = static_cast<int16_t>((re[i] + 1) >> 1);
+                        im[i] = static_cast<int16_t>((im[i] + 1) >> 1);
+                    }
+                    peak = (peak + 1) >> 1;
+                    ++exponent;
+                }
+
+                const size_t half = len >> 1;
+                const size_t stride = N / len;
+                for (size_t i = 0; i < N; i += len)
+                {
+                    for (size_t j = 0; j < half; ++j)
+                    {
+                        // Facteur e^(-2πi·j/len) = cos − i·sin
+                        const int32_t wr = cos_[j * stride];
+                        const int32_t wi = -sin_[j * stride];
+                        const size_t a = i + j;
+                        const size_t b = a + half;
+                        const int32_t tr = (wr * re[b] - wi * im[b] + (1 << 14)) >> 15;
+                        const int32_t ti = (wr * im[b] + wi * re[b] + (1 << 14)) >> 15;
+                        re[b] = static_cast<int16_t>(re[a] - tr);
+                        im[b] = static_cast<int16_t>(im[a] - ti);
+                        re[a] = static_cast<int16_t>(re[a] + tr);
+                        im[a] = static_cast<int16_t>(im[a] + ti);
+                    }
+                }
+            }
+            return exponent;
+        }
+
+        /// Fenêtre de Hann Q15
+        const int16_t *window() const { return window_; }
+
+    private:
+        static int16_t q15(double v)
+        {
+            const double s = std::round(v * 32768.0);
+            return static_cast<int16_t>(s > 32767.0 ? 32767.0 : (s < -32768.0 ? -32768.0 : s));
+        }
+
+        static void swap(int16_t &a, int16_t &b)
+        {
+            const int16_t t = a;
+            a = b;
+            b = t;
+        }
+
+        int16_t cos_[N / 2];
+        int16_t sin_[N / 2];
+        int16_t window_[N];
+    };
+
+} // namespace ina226
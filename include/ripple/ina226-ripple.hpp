@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "sdkconfig.h"
+
+#include "esp_err.h"
+#include "esp_timer.h"
+
+#include "ina226-bus_interface.hpp"
+#include "ina226-registers.hpp"
+#include "config/ina226-config_types.hpp"
+#include "ripple/ina226-fft.hpp"
+
+// Taille de la FFT (Kconfig, menu INA226 Ripple Analysis)
+#ifndef CONFIG_INA226_RIPPLE_FFT_SIZE
+#define CONFIG_INA226_RIPPLE_FFT_SIZE 512
+#endif
+
+namespace ina226
+{
+    /// Réglages d'une rafale de tension bus
+    struct BurstSettings
+    {
+        /// Temps de conversion bus ; fixe la cadence (≈ 1 / conversion) et la bande passante
+        ConfigurationRegister::ConversionTime conversion = ConfigurationRegister::ConversionTime::CT_332us;
+        uint32_t timeout_ms = 2000;
+    };
+
+    /// Déroulement d'une rafale
+    struct BurstInfo
+    {
+        size_t samples = 0;
+        int64_t first_us = 0;
+        int64_t last_us = 0;
+        float sample_rate_hz = 0.0f; // mesurée sur les horodatages
+        uint32_t gaps = 0;           // intervalles > 1,5 × la conversion : échantillons manqués
+        uint32_t polls = 0;          // lectures de 0x06
+    };
+
+    /// Bande [low_hz, high_hz[ ; high_hz ≤ 0 : jusqu'à la fréquence de Nyquist
+    struct RippleBand
+    {
+        float low_hz = 0.0f;
+        float high_hz = 0.0f;
+    };
+
+    /// Résultat d'une analyse ; amplitudes crête d'une sinusoïde, en mV
+    struct RippleReport
+    {
+        static constexpr size_t MAX_PEAKS = 4;
+        static constexpr size_t MAX_BANDS = 4;
+
+        struct Peak
+        {
+            float frequency_hz = 0.0f;
+            float amplitude_mv = 0.0f;
+        };
+
+        struct Band
+        {
+            RippleBand range;
+            float rms_mv = 0.0f;
+        };
+
+        size_t samples = 0;
+        float sample_rate_hz = 0.0f;
+        float resolution_hz = 0.0f; // écart entre deux raies
+        float mean_mv = 0.0f;
+        float peak_to_peak_mv = 0.0f;
+        float rms_mv = 0.0f;        // ondulation (composante continue retirée)
+        Peak peaks[MAX_PEAKS];      // par amplitude décroissante
+        size_t peak_count = 0;
+        Band bands[MAX_BANDS];
+        size_t band_count = 0;
+        uint32_t gaps = 0;          // repris de BurstInfo : cadence non uniforme si > 0
+
+        void log() const;
+        std::string to_json() const;
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 768;
+    };
+
+    /**
+     * @class RippleAnalyzer
+     * @brief Analyse spectrale de l'ondulation de la tension bus à partir d'une rafale de N échantillons.
+     *
+     * Chaîne entièrement entière jusqu'au spectre : retrait de la moyenne, normalisation
+     * à pleine échelle, fenêtre de Hann Q15, FixedFft<N>. Seuls les modules et les
+     * résultats passent en flottant. Tampons et tables sont des membres : aucune
+     * allocation après construction (≈ 12 N octets, instance statique conseillée).
+     *
+     * Limites du composant : deux transactions I2C par échantillon plafonnent la cadence
+     * à quelques kHz, et le CAN intégrateur filtre puis replie tout ce qui dépasse
+     * 1 / (2 × conversion). Cible : ondulation secteur, battements et oscillations de
+     * régulation basse fréquence, pas la fréquence de découpage.
+     */
+    class RippleAnalyzer
+    {
+    public:
+        static constexpr size_t N = CONFIG_INA226_RIPPLE_FFT_SIZE;
+        using Fft = FixedFft<N>;
+
+        RippleAnalyzer();
+
+        RippleAnalyzer(const RippleAnalyzer &) = delete;
+        RippleAnalyzer &operator=(const RippleAnalyzer &) = delete;
+
+        /// Bandes de RippleReport::bands ; par défaut 0–150 Hz, 150 Hz–1 kHz, 1 kHz–Nyquist
+        void set_bands(const RippleBand *bands, size_t count);
+
+        /**
+         * Capture N échantillons dans le tampon interne puis les analyse.
+         * La configuration du composant est modifiée le temps de la rafale puis restaurée :
+         * la tâche d'acquisition ne doit pas lire le composant pendant ce temps.
+         */
+        template <typename Bus>
+        esp_err_t capture(BasicInterface<Bus> &dev, const BurstSettings &settings, RippleReport &out);
+
+        /// Analyse N valeurs brutes du registre 0x02 échantillonnées à `sample_rate_hz`
+        esp_err_t analyze(const uint16_t *bus_raw, size_t count, float sample_rate_hz, RippleReport &out);
+
+        const BurstInfo &last_burst() const { return burst_; }
+
+    private:
+        esp_err_t analyze_buffer(float sample_rate_hz, RippleReport &out);
+        /// Amplitude crête d'une raie, en LSB, à partir de son module au carré
+        float bin_amplitude(size_t k) const;
+
+        Fft fft_;
+        uint16_t raw_[N];
+        int16_t re_[N];
+        int16_t im_[N];
+        float power_[N / 2]; // |X_k|², exposant de bloc appliqué
+        RippleBand bands_[RippleReport::MAX_BANDS];
+        size_t band_count_ = 0;
+        float window_power_ = 0.0f; // Σ w², fenêtre en [0, 1]
+        BurstInfo burst_;
+    };
+
+    /**
+     * Rafale de `n` lectures de la tension bus en mode continu bus seul, sans moyennage.
+     * Chaque échantillon est attendu sur CVRF (0x06) puis lu : aucun doublon ni saut
+     * silencieux, les manques éventuels sont comptés dans BurstInfo::gaps.
+     * La configuration d'origine est réécrite en fin de rafale, même en cas d'erreur.
+     */
+    template <typename Bus>
+    esp_err_t capture_bus_burst(BasicInterface<Bus> &dev, uint16_t *out, size_t n, const BurstSettings &settings,
+                                BurstInfo &info)
+    {
+        using Cfg = reg::Configuration;
+        info = BurstInfo{};
+        if (!out || n < 2)
+            return ESP_ERR_INVALID_ARG;
+
+        uint16_t saved = 0;
+        esp_err_t err = dev.template read<Cfg>(saved);
+        if (err != ESP_OK)
+            return err;
+
+        uint16_t burst = Cfg::AVG::set(saved, 0);
+        burst = Cfg::VBUSCT::set(burst, static_cast<uint16_t>(settings.conversion));
+        burst = Cfg::MODE::set(burst, 0b110); // bus seul, continu
+        err = dev.template write<Cfg>(burst);
+
+        // L'écriture relance la conversion ; efface un CVRF laissé par l'ancienne configuration
+        uint16_t mask = 0;
+        if (err == ESP_OK)
+            err = dev.template read<reg::MaskEnable>(mask);
+
+        const int64_t period_us = ConfigurationRegister::conversion_time_us(settings.conversion);
+        const int64_t deadline = esp_timer_get_time() + static_cast<int64_t>(settings.timeout_ms) * 1000;
+        int64_t prev_us = 0;
+        for (size_t i = 0; i < n && err == ESP_OK; ++i)
+        {
+            do
+            {
+                err = dev.template read<reg::MaskEnable>(mask);
+                ++info.polls;
+                if (err == ESP_OK && !reg::MaskEnable::CVRF::test(mask) && esp_timer_get_time() > deadline)
+                    err = ESP_ERR_TIMEOUT;
+            } while (err == ESP_OK && !reg::MaskEnable::CVRF::test(mask));
+            if (err != ESP_OK)
+                break;
+
+            err = dev.template read<reg::BusVoltage>(out[i]);
+            const int64_t now = esp_timer_get_time();
+            if (i == 0)
+                info.first_us = now;
+            else if (2 * (now - prev_us) > 3 * period_us)
+                ++info.gaps;
+            prev_us = now;
+            info.samples = i + 1;
+        }
+        info.last_us = prev_us;
+
+        const esp_err_t restore = dev.template write<Cfg>(saved);
+        if (err == ESP_OK)
+            err = restore;
+        if (err == ESP_OK && info.last_us > info.first_us)
+            info.sample_rate_hz = (info.samples - 1) * 1e6f / static_cast<float>(info.last_us - info.first_us);
+        return err;
+    }
+
+    template <typename Bus>
+    esp_err_t RippleAnalyzer::capture(BasicInterface<Bus> &dev, const BurstSettings &settings, RippleReport &out)
+    {
+        esp_err_t err = capture_bus_burst(dev, raw_, N, settings, burst_);
+        if (err == ESP_OK)
+            err = analyze_buffer(burst_.sample_rate_hz, out);
+        out.gaps = burst_.gaps;
+        return err;
+    }
+
+} // namespace ina226
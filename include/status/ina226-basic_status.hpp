@@ -0,0 +1,47 @@
+#pragma once
+
+#include "esp_err.h"
+#include <cstdint>
+#include "ina226-bus_interface.hpp"
+#include "status/ina226-status_types.hpp"  // Contient struct StatusRegister avec decode/log/to_json
+
+namespace ina226
+{
+    /**
+     * @class BasicSTATUS
+     * @brief Lecture des drapeaux du registre 0x06 sur le bus `Bus` ; STATUS est l'instance I2CDevices.
+     */
+    template <typename Bus>
+    class BasicSTATUS : public BasicInterface<Bus>
+    {
+    public:
+        explicit BasicSTATUS(Bus &dev) : BasicInterface<Bus>(dev) {}
+
+        StatusRegister status; // Représente les flags du registre 0x06 (Mask/Enable)
+
+        /**
+         * Lit et décode le registre 0x06 de statut.
+         */
+        esp_err_t get()
+        {
+            uint16_t value;
+            esp_err_t err = this->template read<StatusRegister::descriptor>(value);
+            if (err != ESP_OK)
+            {
+                ESP_LOGE(TAG, "Failed to read INA226 status (err=0x%x)", err);
+                return err;
+            }
+
+            status.decode(value);
+            return ESP_OK;
+        }
+
+        void log() const { status.log(); }
+        std::string to_json() const { return status.to_json(); }
+        size_t to_json(char *buf, size_t len) const { return status.to_json(buf, len); }
+        static constexpr size_t JSON_SIZE = StatusRegister::JSON_SIZE;
+
+    private:
+        inline static const char *TAG = "INA226-STATUS";
+    };
+} // namespace ina226
@@ -4,11 +4,14 @@
 #include <string>
 #include "esp_log.h"
 
+#include "ina226-registers.hpp"
+
 namespace ina226
 {
     struct StatusRegister
     {
-        static constexpr uint8_t reg_addr = 0x06;
+        using descriptor = reg::MaskEnable;
+        static constexpr uint8_t reg_addr = descriptor::addr;
 
         // Champs dynamiques
         bool shunt_over_limit = false;
@@ -24,6 +27,9 @@ namespace ina226
 
         void decode(uint16_t reg);
         std::string to_json() const;
+        /// Variante sans allocation ; retourne la longueur écrite
+        size_t to_json(char *buf, size_t len) const;
+        static constexpr size_t JSON_SIZE = 200;
         void log() const;
     };
 }
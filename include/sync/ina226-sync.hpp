@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_err.h"
+
+#include "ina226-common_types.hpp"
+#include "ina226-stats.hpp"
+#include "config/ina226-config.hpp"
+#include "ctrl/ina226-ctrl.hpp"
+
+namespace ina226
+{
+    /// Échantillons appariés d'un déclenchement synchronisé
+    struct SyncSample
+    {
+        static constexpr size_t MAX_DEVICES = 4;
+
+        size_t count = 0;
+        RawSample raw[MAX_DEVICES];
+        int64_t trigger_us[MAX_DEVICES]; // fin de l'écriture de déclenchement de chaque composant
+        int64_t skew_us = 0;             // trigger_us[dernier] - trigger_us[0]
+    };
+
+    /**
+     * @class SyncGroup
+     * @brief Acquisition synchronisée de plusieurs INA226 en mode ShuntAndBusTriggered.
+     *
+     * Chaque écriture du registre de configuration en mode déclenché lance une conversion.
+     * Les écritures sont enchaînées sans autre trafic, puis les résultats sont relevés sur
+     * CVRF : l'écart entre composants est borné par la durée d'une écriture I2C au lieu
+     * d'une période de conversion complète en mode continu.
+     */
+    class SyncGroup
+    {
+    public:
+        /// Ajoute un composant (Config et CTRL du même INA226)
+        esp_err_t add(Config &cfg, CTRL &ctrl);
+
+        /// Passe tous les composants en ShuntAndBusTriggered (réglages de conversion conservés)
+        esp_err_t prepare();
+
+        /// Déclenche tous les composants puis attend CVRF sur chacun et lit les résultats
+        esp_err_t acquire(SyncSample &out, uint32_t timeout_ms = 100);
+
+        size_t size() const { return count_; }
+        const TimingStats &skew_stats() const { return skew_; }
+        uint32_t timeouts() const { return timeouts_; }
+
+        void log() const;
+
+    private:
+        struct Device
+        {
+            Config *cfg;
+            CTRL *ctrl;
+        };
+
+        esp_err_t wait_ready(Device &dev, int64_t deadline_us);
+
+        Device devices_[SyncSample::MAX_DEVICES] = {};
+        size_t count_ = 0;
+        uint32_t period_us_ = 0;
+        TimingStats skew_;
+        uint32_t timeouts_ = 0;
+
+        inline static const char *TAG = "INA226-SYNC";
+    };
+
+} // namespace ina226
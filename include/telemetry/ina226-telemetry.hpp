@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include "esp_err.h"
+
+#include "ina226-common_types.hpp"
+
+namespace ina226
+{
+    enum class TelemetryFormat : uint8_t
+    {
+        JsonLines, // un objet JSON par ligne, mêmes champs que OutputFormat::JSON
+        Csv        // t_us,shunt_uv,bus_mv,current_ma,power_mw
+    };
+
+    /// Seuils de vidage : le premier atteint déclenche l'écriture du lot
+    struct FlushPolicy
+    {
+        uint32_t max_samples = 256; // mesures par lot
+        uint32_t max_age_ms = 1000; // âge maximal de la plus ancienne mesure en attente
+    };
+
+    /// Résumé d'une fenêtre de mesures
+    struct TelemetrySummary
+    {
+        int64_t first_us = 0;
+        int64_t last_us = 0;
+        uint32_t count = 0;
+        float current_min_ma = 0.0f;
+        float current_max_ma = 0.0f;
+        float current_mean_ma = 0.0f;
+        float bus_mean_mv = 0.0f;
+        float power_mean_mw = 0.0f;
+        float energy_mj = 0.0f; // intégrale de la puissance sur la fenêtre (méthode des trapèzes)
+
+        static TelemetrySummary from(const Measurement *samples, size_t count);
+    };
+
+    struct TelemetryStats
+    {
+        uint32_t samples = 0;
+        uint32_t summaries = 0;
+        uint32_t batches = 0;   // appels à write()
+        uint64_t bytes = 0;
+        uint32_t write_errors = 0;
+        uint32_t dropped = 0;   // enregistrements perdus sur erreur d'écriture
+    };
+
+    /**
+     * @class TelemetrySink
+     * @brief Sortie par lots : les mesures sont formatées dans un tampon fourni et écrites
+     *        en une seule opération d'E/S quand un seuil de FlushPolicy est atteint ou que
+     *        le tampon est plein.
+     *
+     * push() et poll() sont appelés par une seule tâche (la tâche de traitement du
+     * gestionnaire) ; aucune allocation après la construction.
+     */
+    class TelemetrySink
+    {
+    public:
+        TelemetrySink(char *buffer, size_t capacity, TelemetryFormat format = TelemetryFormat::JsonLines,
+                      FlushPolicy policy = {});
+        virtual ~TelemetrySink() = default;
+
+        TelemetrySink(const TelemetrySink &) = delete;
+        TelemetrySink &operator=(const TelemetrySink &) = delete;
+
+        esp_err_t push(const Measurement &sample);
+        esp_err_t push(const Measurement *samples, size_t count);
+        esp_err_t push(const TelemetrySummary &summary);
+
+        /// Vide le lot si sa plus ancienne mesure a dépassé max_age_ms
+        esp_err_t poll();
+
+        /// Écrit immédiatement le lot en attente
+        esp_err_t flush();
+
+        const FlushPolicy &policy() const { return policy_; }
+        const TelemetryStats &stats() const { return stats_; }
+
+    protected:
+        /// Une opération d'E/S pour tout le lot
+        virtual esp_err_t write(const char *data, size_t len) = 0;
+
+    private:
+        static constexpr size_t RECORD_SIZE = 256; // plus long enregistrement formaté (résumé)
+
+        /// Ajoute un enregistrement formaté au lot, en vidant d'abord si la place manque
+        esp_err_t append(const char *record, size_t len, bool is_sample);
+        size_t format_sample(char *out, size_t len, const Measurement &m) const;
+
+        char *buf_;
+        size_t capacity_;
+        size_t used_ = 0;
+        uint32_t pending_ = 0;      // enregistrements dans le lot
+        uint32_t pending_samples_ = 0;
+        int64_t oldest_us_ = 0;     // esp_timer au premier enregistrement du lot
+        TelemetryFormat format_;
+        FlushPolicy policy_;
+        TelemetryStats stats_;
+    };
+
+    /**
+     * Console : stdout (UART de la console sur la cible), ou directement un port UART dont
+     * le pilote a été installé par l'application (uart_driver_install).
+     */
+    class UartSink : public TelemetrySink
+    {
+    public:
+        /// `uart_port` < 0 : stdout
+        UartSink(char *buffer, size_t capacity, int uart_port = -1,
+                 TelemetryFormat format = TelemetryFormat::JsonLines, FlushPolicy policy = {});
+
+    protected:
+        esp_err_t write(const char *data, size_t len) override;
+
+    private:
+        int uart_port_;
+    };
+
+    /// Fichier (VFS : SPIFFS, FAT, ou système hôte sur la cible linux)
+    class FileSink : public TelemetrySink
+    {
+    public:
+        FileSink(char *buffer, size_t capacity, TelemetryFormat format = TelemetryFormat::Csv,
+                 FlushPolicy policy = {});
+        ~FileSink() override;
+
+        esp_err_t open(const char *path, bool append = true);
+        esp_err_t close();
+
+    protected:
+        esp_err_t write(const char *data, size_t len) override;
+
+    private:
+        FILE *file_ = nullptr;
+    };
+
+    /**
+     * Datagramme UDP par lot vers un récepteur local (127.0.0.1 par défaut).
+     * Sur la cible linux : `nc -ul 5555` suffit comme récepteur de test.
+     * La capacité du tampon borne la taille des datagrammes (≤ 1472 octets pour éviter
+     * la fragmentation sur Ethernet/Wi-Fi).
+     */
+    class SocketSink : public TelemetrySink
+    {
+    public:
+        SocketSink(char *buffer, size_t capacity, TelemetryFormat format = TelemetryFormat::JsonLines,
+                   FlushPolicy policy = {});
+        ~SocketSink() override;
+
+        esp_err_t open(uint16_t port, const char *ipv4 = "127.0.0.1");
+        esp_err_t close();
+
+    protected:
+        esp_err_t write(const char *data, size_t len) override;
+
+    private:
+        int fd_ = -1;
+        uint32_t addr_ = 0; // ordre réseau
+        uint16_t port_ = 0;
+    };
+
+} // namespace ina226
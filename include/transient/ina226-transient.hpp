@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "ina226-common_types.hpp"
+
+namespace ina226
+{
+    enum class TriggerSource : uint8_t
+    {
+        None,
+        Hardware, // AFF levé dans Mask/Enable (broche ALERT)
+        Software
+    };
+
+    /// Enregistrement contigu : samples[0..pre_count) avant le déclenchement, puis post_count après
+    struct TransientRecord
+    {
+        int64_t trigger_us = 0;
+        TriggerSource source = TriggerSource::None;
+        uint16_t mask_enable = 0;
+        size_t pre_count = 0;
+        size_t post_count = 0;
+        const Measurement *samples = nullptr;
+
+        size_t count() const { return pre_count + post_count; }
+    };
+
+    /**
+     * @class TransientCapture
+     * @brief Capture type oscilloscope autour d'une alerte, dans une mémoire fournie.
+     *
+     * Armée, elle garde en anneau les `pre_samples` derniers échantillons. Au déclenchement,
+     * l'historique est figé et les `post_samples` suivants sont ajoutés à la suite ; la
+     * capture terminée est remise à plat (rotation en place) en un seul bloc horodaté.
+     * push() et trigger() sont appelés par la tâche de traitement ; record() est lisible
+     * depuis n'importe quelle tâche une fois state() == Complete.
+     */
+    class TransientCapture
+    {
+    public:
+        enum class State : uint8_t
+        {
+            Armed,
+            Triggered,
+            Complete
+        };
+
+        /// `storage` doit contenir au moins pre_samples + post_samples éléments
+        TransientCapture(Measurement *storage, size_t capacity, size_t pre_samples, size_t post_samples);
+
+        void push(const Measurement &sample);
+
+        /// Fige l'historique ; false si une capture est déjà en cours ou non relue
+        bool trigger(TriggerSource source, uint16_t mask_enable = 0);
+
+        /// Relance l'enregistrement de l'historique une fois la capture relue (state() == Complete)
+        void rearm();
+
+        State state() const { return state_.load(std::memory_order_acquire); }
+        const TransientRecord &record() const { return record_; }
+
+        size_t pre_samples() const { return pre_; }
+        size_t post_samples() const { return post_; }
+        uint32_t captures() const { return captures_; }
+
+    private:
+        void finish();
+
+        Measurement *buf_;
+        size_t pre_;
+        size_t post_;
+        size_t size_;      // pre_ + post_
+        size_t head_ = 0;  // prochaine position d'écriture
+        size_t filled_ = 0;
+        size_t post_seen_ = 0;
+        int64_t trigger_us_ = 0;
+        uint32_t captures_ = 0;
+
+        std::atomic<State> state_{State::Armed};
+        TransientRecord record_{};
+    };
+
+} // namespace ina226
@@ -0,0 +1,183 @@
+#include "arbiter/ina226-arbiter.hpp"
+
+#include <cinttypes>
+
+#include "esp_log.h"
+
+#include "ina226-clock.hpp"
+#include "ina226-format.hpp"
+
+namespace ina226
+{
+    static const char *TAG = "INA226-ARBITER";
+
+    static const char *CLASS_NAMES[BusArbiter::CLASSES] = {"sample", "control", "bulk"};
+
+    BusArbiter::BusArbiter()
+        : lock_(xSemaphoreCreateMutexStatic(&lock_buf_))
+    {
+        for (auto &w : waiters_)
+            w.sem = xSemaphoreCreateBinaryStatic(&w.sem_buf);
+    }
+
+    void BusArbiter::grant(BusPriority priority, int64_t requested_us, int64_t deadline_us, int64_t now_us)
+    {
+        BusClassStats &s = stats_[static_cast<size_t>(priority)];
+        s.wait.add(now_us - requested_us);
+        if (deadline_us && now_us > deadline_us)
+            ++s.deadline_misses;
+        busy_ = true;
+        holder_ = priority;
+        granted_us_ = now_us;
+    }
+
+    esp_err_t BusArbiter::acquire(BusPriority priority, int64_t deadline_us, TickType_t timeout)
+    {
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        const int64_t now = clock::now_us();
+        BusClassStats &s = stats_[static_cast<size_t>(priority)];
+        ++s.requests;
+        if (!busy_)
+        {
+            grant(priority, now, deadline_us, now);
+            xSemaphoreGive(lock_);
+            return ESP_OK;
+        }
+
+        Waiter *w = nullptr;
+        for (auto &candidate : waiters_)
+        {
+            if (!candidate.used)
+            {
+                w = &candidate;
+                break;
+            }
+        }
+        if (!w)
+        {
+            xSemaphoreGive(lock_);
+            ESP_LOGW(TAG, "Plus de %u demandeurs simultanés", static_cast<unsigned>(MAX_WAITERS));
+            return ESP_ERR_NO_MEM;
+        }
+        ++s.contended;
+        w->used = true;
+        w->granted = false;
+        w->priority = priority;
+        w->deadline_us = deadline_us;
+        w->requested_us = now;
+        w->order = order_++;
+        xSemaphoreGive(lock_);
+
+        const bool woken = xSemaphoreTake(w->sem, timeout) == pdTRUE;
+
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        // Attribution survenue juste après l'expiration : le bus est à nous
+        const bool granted = w->granted;
+        if (granted && !woken)
+            xSemaphoreTake(w->sem, 0);
+        w->used = false;
+        if (!granted)
+            ++s.timeouts;
+        xSemaphoreGive(lock_);
+        return granted ? ESP_OK : ESP_ERR_TIMEOUT;
+    }
+
+    BusArbiter::Waiter *BusArbiter::next_waiter()
+    {
+        Waiter *best = nullptr;
+        for (auto &w : waiters_)
+        {
+            if (!w.used || w.granted)
+                continue;
+            if (!best)
+            {
+                best = &w;
+                continue;
+            }
+            if (w.priority != best->priority)
+            {
+                if (w.priority < best->priority)
+                    best = &w;
+                continue;
+            }
+            // Même classe : échéance la plus proche d'abord, sans échéance ensuite, puis arrivée
+            const int64_t wd = w.deadline_us ? w.deadline_us : INT64_MAX;
+            const int64_t bd = best->deadline_us ? best->deadline_us : INT64_MAX;
+            if (wd < bd || (wd == bd && static_cast<int32_t>(w.order - best->order) < 0))
+                best = &w;
+        }
+        return best;
+    }
+
+    void BusArbiter::release()
+    {
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        const int64_t now = clock::now_us();
+        stats_[static_cast<size_t>(holder_)].hold.add(now - granted_us_);
+        busy_ = false;
+
+        // Passage direct au suivant : le bus ne redevient jamais libre entre deux demandeurs
+        Waiter *w = next_waiter();
+        if (w)
+        {
+            grant(w->priority, w->requested_us, w->deadline_us, now);
+            w->granted = true;
+            xSemaphoreGive(w->sem);
+        }
+        xSemaphoreGive(lock_);
+    }
+
+    BusClassStats BusArbiter::stats(BusPriority priority) const
+    {
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        const BusClassStats s = stats_[static_cast<size_t>(priority)];
+        xSemaphoreGive(lock_);
+        return s;
+    }
+
+    void BusArbiter::reset_stats()
+    {
+        xSemaphoreTake(lock_, portMAX_DELAY);
+        for (auto &s : stats_)
+            s = BusClassStats{};
+        xSemaphoreGive(lock_);
+    }
+
+    void BusArbiter::log() const
+    {
+        for (size_t i = 0; i < CLASSES; ++i)
+        {
+            const BusClassStats s = stats(static_cast<BusPriority>(i));
+            ESP_LOGI(TAG, "%-7s : %" PRIu32 " demandes, %" PRIu32 " en attente, attente mean %" PRId64
+                          " µs max %" PRId64 " µs, tenue mean %" PRId64 " µs max %" PRId64
+                          " µs, échéances manquées %" PRIu32 ", expirations %" PRIu32,
+                     CLASS_NAMES[i], s.requests, s.contended, s.wait.mean_us(), s.wait.max_us, s.hold.mean_us(),
+                     s.hold.max_us, s.deadline_misses, s.timeouts);
+        }
+    }
+
+    size_t BusArbiter::to_json(char *buf, size_t len) const
+    {
+        size_t n = format_to(buf, len, "{");
+        for (size_t i = 0; i < CLASSES; ++i)
+        {
+            const BusClassStats s = stats(static_cast<BusPriority>(i));
+            n += format_to(buf + n, len - n,
+                           "%s\"%s\": {\"requests\": %" PRIu32 ",\"contended\": %" PRIu32 ",\"wait_mean_us\": %" PRId64
+                           ",\"wait_max_us\": %" PRId64 ",\"wait_jitter_us\": %" PRId64 ",\"hold_max_us\": %" PRId64
+                           ",\"deadline_misses\": %" PRIu32 ",\"timeouts\": %" PRIu32 "}",
+                           i ? "," : "", CLASS_NAMES[i], s.requests, s.contended, s.wait.mean_us(), s.wait.max_us,
+                           s.wait.jitter_us(), s.hold.max_us, s.deadline_misses, s.timeouts);
+        }
+        n += format_to(buf + n, len - n, "}");
+        return n;
+    }
+
+    std::string BusArbiter::to_json() const
+    {
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
+    }
+
+} // namespace ina226
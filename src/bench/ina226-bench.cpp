@@ -0,0 +1,468 @@
+#include "bench/ina226-bench.hpp"
+#include "sdkconfig.h"
+
+#if CONFIG_INA226_BENCH
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ina226-alloc_guard.hpp"
+#include "ina226-common_types.hpp"
+#include "ina226-format.hpp"
+#include "config/ina226-config_types.hpp"
+#include "status/ina226-status_types.hpp"
+#include "ctrl/ina226-convert.hpp"
+#include "ctrl/ina226-ctrl_impl.hpp"
+#include "profile/ina226-profile.hpp"
+#include "ripple/ina226-ripple.hpp"
+#include "ina226-sim_bus.hpp"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include "I2CDevices.hpp"
+#include "replay/ina226-replay.hpp"
+#endif
+
+namespace ina226
+{
+    namespace bench
+    {
+        static const char *TAG = "INA226-BENCH";
+
+#if CONFIG_INA226_ALLOC_GUARD
+        static constexpr bool ALLOC_COUNTING = true;
+#else
+        static constexpr bool ALLOC_COUNTING = false;
+#endif
+
+        /// Empêche le compilateur d'éliminer un résultat non utilisé
+        template <typename T>
+        static inline void keep(const T &value)
+        {
+            asm volatile("" : : "r"(&value) : "memory");
+        }
+
+        class Runner
+        {
+        public:
+            Runner(Result *out, size_t max, int64_t min_run_us) : out_(out), max_(max), min_run_us_(min_run_us) {}
+
+            /**
+             * Double le nombre d'itérations jusqu'à couvrir min_run_us, puis enregistre la
+             * dernière passe. `fn(i)` réalise `ops_per_call` opérations.
+             */
+            template <typename F>
+            void measure(const char *name, uint32_t ops_per_call, F &&fn)
+            {
+                if (count_ >= max_)
+                    return;
+
+                uint32_t iterations = 8;
+                int64_t elapsed = 0;
+                uint32_t allocs = 0;
+                while (true)
+                {
+                    const uint32_t a0 = alloc_guard::count();
+                    const int64_t t0 = esp_timer_get_time();
+                    for (uint32_t i = 0; i < iterations; ++i)
+                        fn(i);
+                    elapsed = esp_timer_get_time() - t0;
+                    allocs = alloc_guard::count() - a0;
+                    if (elapsed >= min_run_us_ || iterations >= MAX_ITERATIONS)
+                        break;
+                    iterations *= 2;
+                }
+
+                Result &r = out_[count_++];
+                r.name = name;
+                r.ops = iterations * ops_per_call;
+                r.elapsed_us = elapsed;
+                r.ns_per_op = elapsed * 1000.0 / r.ops;
+                r.allocs_per_op = ALLOC_COUNTING ? static_cast<double>(allocs) / r.ops : -1.0;
+                // Laisse tourner les autres tâches (chien de garde) entre deux cas
+                vTaskDelay(1);
+            }
+
+            /// Erreur relative associée au dernier cas mesuré
+            void annotate(double rel_error)
+            {
+                if (count_)
+                    out_[count_ - 1].rel_error = rel_error;
+            }
+
+            size_t count() const { return count_; }
+
+        private:
+            static constexpr uint32_t MAX_ITERATIONS = 1u << 24;
+
+            Result *out_;
+            size_t max_;
+            int64_t min_run_us_;
+            size_t count_ = 0;
+        };
+
+        // === Registres ===
+
+        static void bench_registers(Runner &r)
+        {
+            ConfigurationRegister config;
+            r.measure("config.set_values", 1, [&](uint32_t i) {
+                ConfigurationRegister::ConfigurationReg v;
+                v.averaging = static_cast<ConfigurationRegister::AveragingMode>(i & 7);
+                v.bus_conv_time = static_cast<ConfigurationRegister::ConversionTime>((i >> 3) & 7);
+                v.shunt_conv_time = static_cast<ConfigurationRegister::ConversionTime>((i >> 6) & 7);
+                v.mode = static_cast<ConfigurationRegister::OperatingMode>((i >> 9) & 7);
+                config.set_values(v);
+                keep(config);
+            });
+            r.measure("config.get_values", 1, [&](uint32_t i) {
+                config.set_raw(static_cast<uint16_t>(i));
+                ConfigurationRegister::ConfigurationReg v = config.get_values();
+                keep(v);
+            });
+
+            MaskEnableRegister mask;
+            r.measure("mask_enable.set_values", 1, [&](uint32_t i) {
+                MaskEnableRegister::MaskEnableReg v;
+                v.alert_type = static_cast<AlertType>(i % 6);
+                v.conversion_ready = i & 1;
+                v.alert_polarity_bit = i & 2;
+                v.alert_latch_enable = i & 4;
+                mask.set_values(v);
+                keep(mask);
+            });
+            r.measure("mask_enable.get_values", 1, [&](uint32_t i) {
+                mask.set_raw(static_cast<uint16_t>(i * 0x9E37u));
+                MaskEnableRegister::MaskEnableReg v = mask.get_values();
+                keep(v);
+            });
+
+            StatusRegister status;
+            r.measure("status.decode", 1, [&](uint32_t i) {
+                status.decode(static_cast<uint16_t>(i * 0x9E37u));
+                keep(status);
+            });
+        }
+
+        // === Calibration ===
+
+        static void bench_calibration(Runner &r)
+        {
+            // Shunts et courants usuels, des cas à petit LSB aux plus grossiers
+            static constexpr uint16_t SHUNTS_MOHM[] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000};
+            static constexpr uint16_t MAX_CURRENTS_MA[] = {100, 500, 1000, 3200, 8000, 20000};
+            static constexpr size_t N_SHUNT = sizeof(SHUNTS_MOHM) / sizeof(SHUNTS_MOHM[0]);
+            static constexpr size_t N_CURRENT = sizeof(MAX_CURRENTS_MA) / sizeof(MAX_CURRENTS_MA[0]);
+
+            CalibrationRegister cal;
+            r.measure("calibration.set_value", N_SHUNT * N_CURRENT, [&](uint32_t) {
+                for (size_t s = 0; s < N_SHUNT; ++s)
+                {
+                    for (size_t c = 0; c < N_CURRENT; ++c)
+                    {
+                        cal.set_value({SHUNTS_MOHM[s], MAX_CURRENTS_MA[c]});
+                        keep(cal);
+                    }
+                }
+            });
+            // Petit shunt et faible courant : borne CAL ≤ 32767 active
+            r.measure("calibration.set_value.worst", 1, [&](uint32_t) {
+                cal.set_value({1, 100});
+                keep(cal);
+            });
+            r.measure("calibration.current_lsb_na", 1, [&](uint32_t i) {
+                uint32_t lsb = current_lsb_na(static_cast<uint16_t>(i | 1), 100);
+                keep(lsb);
+            });
+        }
+
+        // === Conversion d'unités ===
+
+        static void bench_conversion(Runner &r)
+        {
+            static constexpr size_t BATCH = 256;
+            static RawSample raw[BATCH];
+            static Measurement out[BATCH];
+            for (size_t i = 0; i < BATCH; ++i)
+            {
+                raw[i].timestamp_us = static_cast<int64_t>(i) * 1000;
+                raw[i].shunt = static_cast<int16_t>(i * 37 - 4000);
+                raw[i].bus = static_cast<uint16_t>(9600 + i);
+                raw[i].power = static_cast<uint16_t>(i * 11);
+                raw[i].current = static_cast<int16_t>(i * 13 - 1500);
+            }
+            const ConversionScale scale = ConversionScale::from_calibration(2048, 100);
+
+            r.measure("convert.samples", BATCH, [&](uint32_t) {
+                convert_samples(raw, out, BATCH, scale);
+                keep(out);
+            });
+            r.measure("convert.samples_scalar", BATCH, [&](uint32_t) {
+                convert_samples_scalar(raw, out, BATCH, scale);
+                keep(out);
+            });
+            r.measure("convert.scale_from_calibration", 1, [&](uint32_t i) {
+                ConversionScale s = ConversionScale::from_calibration(static_cast<uint16_t>(i | 1), 100);
+                keep(s);
+            });
+        }
+
+        // === Quantiles ===
+
+        /// Profil de charge synthétique : repos ~20 mA, pointes à queue lourde, recharges négatives
+        static float synthetic_current(uint32_t &state)
+        {
+            state = state * 1664525u + 1013904223u;
+            const float u = (state >> 8) * (1.0f / 16777216.0f);
+            const float v = 18.0f + 4.0f * u + 3000.0f * u * u * u * u * u * u * u * u;
+            return (state & 0x3F) == 0 ? -v : v;
+        }
+
+        static void bench_quantile(Runner &r)
+        {
+            static LoadProfile::CurrentSketch sketch;
+            static LoadProfile::CurrentSketch other;
+            uint32_t state = 1;
+
+            r.measure("quantile.add", 1, [&](uint32_t) {
+                sketch.add(synthetic_current(state));
+            });
+
+            // Précision : quantiles du sketch face aux quantiles exacts d'un même flux
+            static constexpr size_t N = 4096;
+            static float exact[N];
+            sketch.reset();
+            state = 7;
+            for (size_t i = 0; i < N; ++i)
+            {
+                exact[i] = synthetic_current(state);
+                sketch.add(exact[i]);
+            }
+            std::sort(exact, exact + N);
+            double worst = 0.0;
+            for (double q : LoadProfile::QUANTILES)
+            {
+                const float ref = exact[static_cast<size_t>(q * (N - 1))];
+                const double err = std::fabs(sketch.quantile(q) - ref) / std::fabs(ref);
+                worst = err > worst ? err : worst;
+            }
+
+            r.measure("quantile.p99", 1, [&](uint32_t) {
+                float v = sketch.quantile(0.99);
+                keep(v);
+            });
+            r.annotate(worst);
+
+            static uint8_t encoded[LoadProfile::CurrentSketch::MAX_ENCODED_SIZE];
+            size_t len = 0;
+            r.measure("quantile.encode", 1, [&](uint32_t) {
+                len = sketch.encode(encoded, sizeof(encoded));
+                keep(len);
+            });
+            r.measure("quantile.merge_encoded", 1, [&](uint32_t) {
+                esp_err_t err = other.merge_encoded(encoded, len);
+                keep(err);
+            });
+        }
+
+        // === Ondulation ===
+
+        static void bench_ripple(Runner &r)
+        {
+            static constexpr size_t N = RippleAnalyzer::N;
+            static constexpr float SAMPLE_RATE_HZ = 2000.0f;
+            static constexpr float RIPPLE_MV = 20.0f;
+
+            // Rafale synthétique : 12 V, 20 mV crête à 104,3 Hz (entre deux raies), bruit ± 1 LSB
+            static uint16_t raw[N];
+            uint32_t state = 5;
+            for (size_t i = 0; i < N; ++i)
+            {
+                state = state * 1664525u + 1013904223u;
+                const float noise = ((state >> 8) & 0xFF) / 128.0f - 1.0f;
+                const float mv = 12000.0f + RIPPLE_MV * std::sin(2.0f * static_cast<float>(M_PI) * 104.3f * i /
+                                                                 SAMPLE_RATE_HZ);
+                raw[i] = static_cast<uint16_t>(std::lround(mv / 1.25f + noise));
+            }
+
+            // Noyau seul, copie de l'entrée comprise (la transformée est en place)
+            static RippleAnalyzer::Fft fft;
+            static int16_t input[N];
+            static int16_t re[N];
+            static int16_t im[N];
+            for (size_t i = 0; i < N; ++i)
+                input[i] = static_cast<int16_t>((raw[i] - 9600) * 256);
+            r.measure("ripple.fft", 1, [&](uint32_t) {
+                std::memcpy(re, input, sizeof(re));
+                std::memset(im, 0, sizeof(im));
+                int e = fft.forward(re, im);
+                keep(e);
+                keep(re);
+            });
+
+            // Chaîne complète : fenêtre, FFT, raies et bandes
+            static RippleAnalyzer analyzer;
+            RippleReport report;
+            r.measure("ripple.analyze", 1, [&](uint32_t) {
+                esp_err_t err = analyzer.analyze(raw, N, SAMPLE_RATE_HZ, report);
+                keep(err);
+            });
+            r.annotate(report.peak_count ? std::fabs(report.peaks[0].amplitude_mv - RIPPLE_MV) / RIPPLE_MV : 1.0);
+        }
+
+        // === CTRL ===
+
+        struct CtrlNames
+        {
+            const char *get;
+            const char *get_raw;
+            const char *json;
+            const char *json_string;
+        };
+
+        /// Même code pilote quel que soit le bus : seul le coût du transport change
+        template <typename Ctrl>
+        static void bench_ctrl(Runner &r, Ctrl &ctrl, const CtrlNames &names)
+        {
+            r.measure(names.get, 1, [&](uint32_t) {
+                ctrl.get();
+                keep(ctrl);
+            });
+            r.measure(names.get_raw, 1, [&](uint32_t) {
+                RawSample s;
+                ctrl.get_raw(s);
+                keep(s);
+            });
+
+            if (names.json == nullptr)
+                return;
+            char buf[Ctrl::JSON_SIZE];
+            r.measure(names.json, 1, [&](uint32_t) {
+                size_t n = ctrl.to_json(buf, sizeof(buf));
+                keep(n);
+            });
+            r.measure(names.json_string, 1, [&](uint32_t) {
+                std::string s = ctrl.to_json();
+                keep(s);
+            });
+        }
+
+        // === Sérialisation ===
+
+        /// Variante tampon puis variante std::string d'un même objet
+        template <typename T>
+        static void bench_json(Runner &r, const char *name, const char *name_string, const T &obj)
+        {
+            char buf[T::JSON_SIZE];
+            r.measure(name, 1, [&](uint32_t) {
+                size_t n = obj.to_json(buf, sizeof(buf));
+                keep(n);
+            });
+            r.measure(name_string, 1, [&](uint32_t) {
+                std::string s = obj.to_json();
+                keep(s);
+            });
+        }
+
+        static void bench_serialization(Runner &r)
+        {
+            ConfigParams params;
+            params.configuration.set_raw(0x4127);
+            params.calibration.set_value({100, 3200});
+            params.alert_mask.set_values({AlertType::BusOverVoltage, true, false, true});
+            params.alert_limit.set_type(AlertType::BusOverVoltage);
+            params.alert_limit.set_value(12000);
+
+            StatusRegister status;
+            status.decode(0x2408);
+
+            bench_json(r, "json.configuration", "json.configuration.string", params.configuration);
+            bench_json(r, "json.calibration", "json.calibration.string", params.calibration);
+            bench_json(r, "json.mask_enable", "json.mask_enable.string", params.alert_mask);
+            bench_json(r, "json.alert_limit", "json.alert_limit.string", params.alert_limit);
+            bench_json(r, "json.config_params", "json.config_params.string", params);
+            bench_json(r, "json.status", "json.status.string", status);
+        }
+
+        size_t run(Result *out, size_t max, CTRL *ctrl, int64_t min_run_us)
+        {
+            Runner r(out, max, min_run_us);
+
+            // Bus simulé en mémoire : coût du pilote seul, identique sur cible et hôte
+            SimBus sim;
+            sim.set(reg::ShuntVoltage::addr, static_cast<uint16_t>(-1200));
+            sim.set(reg::BusVoltage::addr, 9600);
+            sim.set(reg::Power::addr, 150);
+            sim.set(reg::Current::addr, 3000);
+            sim.set(reg::ManufacturerId::addr, reg::ManufacturerId::TI);
+            BasicCTRL<SimBus> sim_ctrl(sim);
+
+#if CONFIG_IDF_TARGET_LINUX
+            // Chemin I2CDevices de la cible linux : rejeu figé sur un échantillon
+            static const RawSample sample = {0, -1200, 9600, 150, 3000};
+            ReplayBus bus;
+            bus.load(&sample, 1, 2048);
+            bus.step();
+            I2CDevices dev(bus);
+            CTRL replay_ctrl(dev);
+            if (ctrl == nullptr)
+                ctrl = &replay_ctrl;
+#endif
+
+            bench_registers(r);
+            bench_calibration(r);
+            bench_conversion(r);
+            bench_ctrl(r, sim_ctrl, {"ctrl.sim.get", "ctrl.sim.get_raw", "json.ctrl", "json.ctrl.string"});
+            if (ctrl)
+                bench_ctrl(r, *ctrl, {"ctrl.get", "ctrl.get_raw", nullptr, nullptr});
+            bench_serialization(r);
+            bench_quantile(r);
+            bench_ripple(r);
+            return r.count();
+        }
+
+        void print_json(FILE *stream, const Result *results, size_t count)
+        {
+            fprintf(stream, "{\"component\":\"ina226\",\"alloc_counting\":%s,\"results\":[",
+                    bool_str(ALLOC_COUNTING));
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Result &res = results[i];
+                fprintf(stream, "%s{\"name\":\"%s\",\"ops\":%" PRIu32 ",\"elapsed_us\":%" PRId64 ",\"ns_per_op\":%.2f,",
+                        i ? "," : "", res.name, res.ops, res.elapsed_us, res.ns_per_op);
+                if (res.allocs_per_op < 0)
+                    fprintf(stream, "\"allocs_per_op\":null");
+                else
+                    fprintf(stream, "\"allocs_per_op\":%.3f", res.allocs_per_op);
+                if (res.rel_error >= 0)
+                    fprintf(stream, ",\"rel_error\":%.5f", res.rel_error);
+                fprintf(stream, "}");
+            }
+            fprintf(stream, "]}\n");
+        }
+
+        void log(const Result *results, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Result &res = results[i];
+                if (res.allocs_per_op < 0)
+                    ESP_LOGI(TAG, "%-32s %10.1f ns/op", res.name, res.ns_per_op);
+                else
+                    ESP_LOGI(TAG, "%-32s %10.1f ns/op %6.2f allocs/op", res.name, res.ns_per_op, res.allocs_per_op);
+                if (res.rel_error >= 0)
+                    ESP_LOGI(TAG, "%-32s %10.3f %% erreur relative max", "", res.rel_error * 100.0);
+            }
+        }
+    } // namespace bench
+
+} // namespace ina226
+
+#endif // CONFIG_INA226_BENCH
@@ -0,0 +1,369 @@
+#include "capture/ina226-capture.hpp"
+#include "ina226-crc.hpp"
+#include "ctrl/ina226-convert.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "esp_log.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ina226
+{
+    // === CaptureWriter ===
+
+    CaptureWriter::CaptureWriter(uint32_t samples_per_block)
+        : samples_per_block_(samples_per_block ? samples_per_block : 1)
+    {}
+
+    CaptureWriter::~CaptureWriter()
+    {
+        if (file_)
+            close();
+    }
+
+    esp_err_t CaptureWriter::open(const char *path, const ConfigParams &params, uint16_t shunt_res_milliohm,
+                                  int64_t epoch_offset_us)
+    {
+        if (file_)
+            return ESP_ERR_INVALID_STATE;
+
+        file_ = fopen(path, "wb");
+        if (!file_)
+        {
+            ESP_LOGE(TAG, "Impossible de créer %s", path);
+            return ESP_FAIL;
+        }
+
+        CaptureFileHeader header{};
+        memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+        header.version = CAPTURE_VERSION;
+        header.header_size = sizeof(CaptureFileHeader);
+        header.block_size = capture_block_size(samples_per_block_);
+        header.samples_per_block = samples_per_block_;
+        header.config_raw = params.configuration.get_raw();
+        header.calibration_raw = params.calibration.get_raw();
+        header.alert_mask_raw = params.alert_mask.get_raw();
+        header.alert_limit_raw = params.alert_limit.get_raw();
+        header.alert_type = static_cast<uint8_t>(params.alert_limit.get_type());
+        header.shunt_res_milliohm = shunt_res_milliohm;
+        header.epoch_offset_us = epoch_offset_us;
+
+        header.current_lsb_na = current_lsb_na(header.calibration_raw, shunt_res_milliohm);
+
+        if (fwrite(&header, sizeof(header), 1, file_) != 1)
+        {
+            fclose(file_);
+            file_ = nullptr;
+            return ESP_FAIL;
+        }
+
+        records_.clear();
+        records_.reserve(samples_per_block_);
+        index_.clear();
+        last_us_ = INT64_MIN;
+        write_error_ = ESP_OK;
+        return ESP_OK;
+    }
+
+    esp_err_t CaptureWriter::append(const RawSample &sample)
+    {
+        if (!file_)
+            return ESP_ERR_INVALID_STATE;
+        if (write_error_ != ESP_OK)
+            return write_error_;
+        if (sample.timestamp_us < last_us_)
+            return ESP_ERR_INVALID_ARG;
+
+        // Le décalage est sur 32 bits : un bloc couvre au plus ~71 minutes
+        if (!records_.empty() && static_cast<uint64_t>(sample.timestamp_us - block_.first_us) > UINT32_MAX)
+        {
+            esp_err_t err = flush();
+            if (err != ESP_OK)
+                return err;
+        }
+
+        if (records_.empty())
+            block_.first_us = sample.timestamp_us;
+
+        CaptureRecord rec;
+        rec.offset_us = static_cast<uint32_t>(sample.timestamp_us - block_.first_us);
+        rec.shunt = sample.shunt;
+        rec.bus = sample.bus;
+        rec.power = sample.power;
+        rec.current = sample.current;
+        records_.push_back(rec);
+
+        block_.last_us = sample.timestamp_us;
+        last_us_ = sample.timestamp_us;
+
+        if (records_.size() >= samples_per_block_)
+            return flush();
+        return ESP_OK;
+    }
+
+    esp_err_t CaptureWriter::flush()
+    {
+        if (!file_)
+            return ESP_ERR_INVALID_STATE;
+        if (write_error_ != ESP_OK)
+            return write_error_;
+        if (records_.empty())
+            return ESP_OK;
+
+        const uint32_t count = static_cast<uint32_t>(records_.size());
+        block_.magic = CAPTURE_BLOCK_MAGIC;
+        block_.count = count;
+        block_.sequence = static_cast<uint32_t>(index_.size());
+        block_.crc32 = crc32(records_.data(), count * sizeof(CaptureRecord));
+
+        // Padding à zéro pour garder des blocs de taille fixe
+        records_.resize(samples_per_block_);
+
+        bool ok = fwrite(&block_, sizeof(block_), 1, file_) == 1 &&
+                  fwrite(records_.data(), sizeof(CaptureRecord), samples_per_block_, file_) == samples_per_block_ &&
+                  fflush(file_) == 0;
+
+        records_.clear();
+
+        if (!ok)
+        {
+            // Bloc absent ou tronqué : il n'entre pas dans l'index
+            ESP_LOGE(TAG, "Écriture du bloc %u échouée", static_cast<unsigned>(block_.sequence));
+            write_error_ = ESP_FAIL;
+            return write_error_;
+        }
+        index_.push_back({block_.first_us});
+        return ESP_OK;
+    }
+
+    esp_err_t CaptureWriter::close()
+    {
+        if (!file_)
+            return ESP_ERR_INVALID_STATE;
+
+        esp_err_t err = flush();
+
+        CaptureFooter footer{};
+        footer.magic = CAPTURE_FOOTER_MAGIC;
+        footer.block_count = static_cast<uint32_t>(index_.size());
+        footer.index_offset = sizeof(CaptureFileHeader) +
+                              static_cast<uint64_t>(index_.size()) * capture_block_size(samples_per_block_);
+
+        if (err == ESP_OK &&
+            (fwrite(index_.data(), sizeof(CaptureIndexEntry), index_.size(), file_) != index_.size() ||
+             fwrite(&footer, sizeof(footer), 1, file_) != 1))
+            err = ESP_FAIL;
+
+        if (fclose(file_) != 0 && err == ESP_OK)
+            err = ESP_FAIL;
+        file_ = nullptr;
+        index_.clear();
+        return err;
+    }
+
+#if CONFIG_IDF_TARGET_LINUX
+    // === CaptureReader ===
+
+    CaptureReader::~CaptureReader()
+    {
+        close();
+    }
+
+    esp_err_t CaptureReader::open(const char *path)
+    {
+        close();
+
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return ESP_ERR_NOT_FOUND;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CaptureFileHeader))
+        {
+            ::close(fd);
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        size_ = static_cast<size_t>(st.st_size);
+        void *map = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+        {
+            size_ = 0;
+            return ESP_FAIL;
+        }
+        data_ = static_cast<const uint8_t *>(map);
+        madvise(map, size_, MADV_RANDOM);
+
+        header_ = reinterpret_cast<const CaptureFileHeader *>(data_);
+        if (memcmp(header_->magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 ||
+            header_->version != CAPTURE_VERSION ||
+            header_->header_size != sizeof(CaptureFileHeader) ||
+            header_->samples_per_block == 0 ||
+            header_->block_size != capture_block_size(header_->samples_per_block))
+        {
+            ESP_LOGE(TAG, "%s n'est pas une capture INA226 v%u", path, CAPTURE_VERSION);
+            close();
+            return ESP_ERR_INVALID_VERSION;
+        }
+
+        const size_t body = size_ - header_->header_size;
+
+        // Index de fin de fichier si la capture a été fermée proprement
+        if (size_ >= sizeof(CaptureFileHeader) + sizeof(CaptureFooter))
+        {
+            const auto *footer = reinterpret_cast<const CaptureFooter *>(data_ + size_ - sizeof(CaptureFooter));
+            const uint64_t expected_offset = header_->header_size +
+                                             static_cast<uint64_t>(footer->block_count) * header_->block_size;
+            if (footer->magic == CAPTURE_FOOTER_MAGIC &&
+                footer->index_offset == expected_offset &&
+                expected_offset + footer->block_count * sizeof(CaptureIndexEntry) + sizeof(CaptureFooter) == size_)
+            {
+                index_ = reinterpret_cast<const CaptureIndexEntry *>(data_ + footer->index_offset);
+                block_count_ = footer->block_count;
+                return ESP_OK;
+            }
+        }
+
+        // Sinon : blocs complets uniquement, en ignorant une fin tronquée ou déchirée
+        block_count_ = body / header_->block_size;
+        while (block_count_ > 0 && !verify_block(block_count_ - 1))
+            --block_count_;
+        ESP_LOGW(TAG, "%s sans index, %u blocs récupérés", path, static_cast<unsigned>(block_count_));
+        return ESP_OK;
+    }
+
+    void CaptureReader::close()
+    {
+        if (data_)
+            munmap(const_cast<uint8_t *>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+        header_ = nullptr;
+        index_ = nullptr;
+        block_count_ = 0;
+    }
+
+    const CaptureBlockHeader &CaptureReader::block(size_t k) const
+    {
+        return *reinterpret_cast<const CaptureBlockHeader *>(data_ + header_->header_size + k * header_->block_size);
+    }
+
+    const CaptureRecord *CaptureReader::records(size_t k) const
+    {
+        return reinterpret_cast<const CaptureRecord *>(&block(k) + 1);
+    }
+
+    size_t CaptureReader::record_count(size_t k) const
+    {
+        const CaptureBlockHeader &blk = block(k);
+        if (blk.magic != CAPTURE_BLOCK_MAGIC)
+            return 0;
+        return blk.count < header_->samples_per_block ? blk.count : header_->samples_per_block;
+    }
+
+    int64_t CaptureReader::block_first_us(size_t k) const
+    {
+        return index_ ? index_[k].first_us : block(k).first_us;
+    }
+
+    int64_t CaptureReader::first_time_us() const
+    {
+        return block_count_ ? block_first_us(0) : 0;
+    }
+
+    int64_t CaptureReader::last_time_us() const
+    {
+        return block_count_ ? block(block_count_ - 1).last_us : 0;
+    }
+
+    CapturePosition CaptureReader::seek(int64_t t_us) const
+    {
+        // Dernier bloc dont le premier enregistrement est <= t_us
+        size_t lo = 0, hi = block_count_;
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            if (block_first_us(mid) <= t_us)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo == 0)
+            return {0, 0};
+
+        const size_t k = lo - 1;
+        const CaptureBlockHeader &blk = block(k);
+        if (t_us > blk.last_us)
+            return {k + 1, 0};
+
+        const uint32_t offset = static_cast<uint32_t>(t_us - blk.first_us);
+        const CaptureRecord *first = records(k);
+        const CaptureRecord *it = std::lower_bound(first, first + record_count(k), offset,
+                                                   [](const CaptureRecord &r, uint32_t off)
+                                                   { return r.offset_us < off; });
+        return {k, static_cast<size_t>(it - first)};
+    }
+
+    size_t CaptureReader::read(CapturePosition &pos, RawSample *out, size_t max, int64_t until_us) const
+    {
+        size_t n = 0;
+        while (n < max && pos.block < block_count_)
+        {
+            const CaptureBlockHeader &blk = block(pos.block);
+            const CaptureRecord *rec = records(pos.block);
+            const size_t count = record_count(pos.block);
+            while (n < max && pos.index < count)
+            {
+                const CaptureRecord &r = rec[pos.index];
+                const int64_t t = blk.first_us + r.offset_us;
+                // Enregistrements triés : tout ce qui suit est aussi hors plage
+                if (t >= until_us)
+                    return n;
+                ++pos.index;
+                RawSample &s = out[n++];
+                s.timestamp_us = t;
+                s.shunt = r.shunt;
+                s.bus = r.bus;
+                s.power = r.power;
+                s.current = r.current;
+            }
+            if (pos.index >= count)
+            {
+                ++pos.block;
+                pos.index = 0;
+            }
+        }
+        return n;
+    }
+
+    size_t CaptureReader::read_range(int64_t t0_us, int64_t t1_us, RawSample *out, size_t max) const
+    {
+        CapturePosition pos = seek(t0_us);
+        return read(pos, out, max, t1_us);
+    }
+
+    void CaptureReader::decode(const RawSample *in, size_t count, Measurement *out) const
+    {
+        convert_samples(in, out, count, ConversionScale::from_current_lsb_na(header_->current_lsb_na));
+    }
+
+    bool CaptureReader::verify_block(size_t k) const
+    {
+        if (k >= block_count_)
+            return false;
+        const CaptureBlockHeader &blk = block(k);
+        return blk.magic == CAPTURE_BLOCK_MAGIC &&
+               blk.count <= header_->samples_per_block &&
+               blk.crc32 == crc32(records(k), blk.count * sizeof(CaptureRecord));
+    }
+#endif
+
+} // namespace ina226
@@ -1,5 +1,8 @@
 #include "config/ina226-config_types.hpp"
 #include "ina226-common_types.hpp"
+#include "ina226-format.hpp"
+
+#include <cinttypes>
 
 #include "esp_log.h"
 
@@ -9,70 +12,79 @@ namespace ina226
 
     ConfigurationRegister::ConfigurationReg ConfigurationRegister::get_values() const
     {
+        using R = reg::Configuration;
         ConfigurationReg values;
-        values.averaging = static_cast<AveragingMode>((raw_ >> 9) & 0x07);
-        values.bus_conv_time = static_cast<ConversionTime>((raw_ >> 6) & 0x07);
-        values.shunt_conv_time = static_cast<ConversionTime>((raw_ >> 3) & 0x07);
-        values.mode = static_cast<OperatingMode>(raw_ & 0x07);
+        values.averaging = static_cast<AveragingMode>(R::AVG::get(raw_));
+        values.bus_conv_time = static_cast<ConversionTime>(R::VBUSCT::get(raw_));
+        values.shunt_conv_time = static_cast<ConversionTime>(R::VSHCT::get(raw_));
+        values.mode = static_cast<OperatingMode>(R::MODE::get(raw_));
         return values;
     }
 
     void ConfigurationRegister::set_values(ConfigurationRegister::ConfigurationReg values)
     {
+        using R = reg::Configuration;
+        raw_ = R::AVG::set(raw_, static_cast<uint16_t>(values.averaging));
+        raw_ = R::VBUSCT::set(raw_, static_cast<uint16_t>(values.bus_conv_time));
+        raw_ = R::VSHCT::set(raw_, static_cast<uint16_t>(values.shunt_conv_time));
+        raw_ = R::MODE::set(raw_, static_cast<uint16_t>(values.mode));
+    }
 
-        raw_ &= ~(0b111 << 9);  // Clear averaging
-        raw_ |= (static_cast<uint16_t>(values.averaging) << 9);
-    
-        raw_ &= ~(0b111 << 6);  // Clear bus_conv_time
-        raw_ |= (static_cast<uint16_t>(values.bus_conv_time) << 6);
-    
-        raw_ &= ~(0b111 << 3);  // Clear shunt_conv_time
-        raw_ |= (static_cast<uint16_t>(values.shunt_conv_time) << 3);
-    
-        raw_ &= ~0b111;         // Clear mode
-        raw_ |= static_cast<uint16_t>(values.mode);
+    uint32_t ConfigurationRegister::conversion_period_us() const
+    {
+        ConfigurationReg values = get_values();
+        const uint8_t mode = static_cast<uint8_t>(values.mode);
+        uint32_t period = 0;
+        if (mode & 0b001) // voie shunt active
+            period += conversion_time_us(values.shunt_conv_time);
+        if (mode & 0b010) // voie bus active
+            period += conversion_time_us(values.bus_conv_time);
+        return period * sample_count(values.averaging);
     }
 
     void ConfigurationRegister::log() const
     {
         ConfigurationReg values = get_values();
+        std::string_view avg = to_string(values.averaging);
+        std::string_view bus_ct = to_string(values.bus_conv_time);
+        std::string_view shunt_ct = to_string(values.shunt_conv_time);
+        std::string_view mode = to_string(values.mode);
         ESP_LOGI(TAG, "Raw value        : 0x%04X", raw_);
-        ESP_LOGI(TAG, "Averaging        : %s", to_string(values.averaging));
-        ESP_LOGI(TAG, "Bus Conv Time    : %s", to_string(values.bus_conv_time));
-        ESP_LOGI(TAG, "Shunt Conv Time  : %s", to_string(values.shunt_conv_time));
-        ESP_LOGI(TAG, "Operating Mode   : %s", to_string(values.mode));
+        ESP_LOGI(TAG, "Averaging        : %.*s", static_cast<int>(avg.size()), avg.data());
+        ESP_LOGI(TAG, "Bus Conv Time    : %.*s", static_cast<int>(bus_ct.size()), bus_ct.data());
+        ESP_LOGI(TAG, "Shunt Conv Time  : %.*s", static_cast<int>(shunt_ct.size()), shunt_ct.data());
+        ESP_LOGI(TAG, "Operating Mode   : %.*s", static_cast<int>(mode.size()), mode.data());
     }
 
-    std::string ConfigurationRegister::to_json() const
+    size_t ConfigurationRegister::to_json(char *buf, size_t len) const
     {
         ConfigurationReg values = get_values();
-        return std::string("{") +
-               "\"value\": " + std::to_string(raw_) + "," +
-               "\"averaging\": " + to_string(values.averaging) + "," +
-               "\"bus_conv_time\": " + to_string(values.bus_conv_time) + "," +
-               "\"shunt_conv_time\": " + to_string(values.shunt_conv_time) + "," +
-               "\"mode\": " + to_string(values.mode) +
-               "}";
+        std::string_view avg = to_string(values.averaging);
+        std::string_view bus_ct = to_string(values.bus_conv_time);
+        std::string_view shunt_ct = to_string(values.shunt_conv_time);
+        std::string_view mode = to_string(values.mode);
+        return format_to(buf, len,
+                         "{\"value\": %u,\"averaging\": \"%.*s\",\"bus_conv_time\": \"%.*s\","
+                         "\"shunt_conv_time\": \"%.*s\",\"mode\": \"%.*s\"}",
+                         raw_,
+                         static_cast<int>(avg.size()), avg.data(),
+                         static_cast<int>(bus_ct.size()), bus_ct.data(),
+                         static_cast<int>(shunt_ct.size()), shunt_ct.data(),
+                         static_cast<int>(mode.size()), mode.data());
     }
 
-    void CalibrationRegister::set_value(CalibrationReg values)
+    std::string ConfigurationRegister::to_json() const
     {
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
+    }
 
-        if (values.shunt_res_milliohm == 0 || values.max_current_ma == 0) return ;
-    
-        // LSB initial pour couvrir max_current_ma sur 15 bits
-        uint32_t current_lsb_uA = (static_cast<uint32_t>(values.max_current_ma) * 1000 + MAX_CAL) / (MAX_CAL + 1);
-    
-        // On augmente le LSB jusqu’à obtenir un CAL ≤ 32767
-        while ((CAL_CONST / (current_lsb_uA * values.shunt_res_milliohm)) > MAX_CAL) {
-            current_lsb_uA++;
-            if (current_lsb_uA > 100000) return; // protection de boucle
-        }
-        
-        uint64_t denom = static_cast<uint64_t>(current_lsb_uA) * values.shunt_res_milliohm;
-        if (denom == 0) return; // Overflow ou mauvaise entrée
-
-        raw_ = static_cast<uint16_t>(CAL_CONST / denom);
+    void CalibrationRegister::set_value(CalibrationReg values)
+    {
+        const Solution solution = solve(values);
+        if (!solution.valid) return;
+        raw_ = solution.cal;
     }
 
     void CalibrationRegister::log() const
@@ -82,70 +94,51 @@ namespace ina226
         ESP_LOGI(TAG, "Calibration Value: %u", value);
     }
 
+    size_t CalibrationRegister::to_json(char *buf, size_t len) const
+    {
+        return format_to(buf, len, "{\"value\": %u}", get_value());
+    }
+
     std::string CalibrationRegister::to_json() const
     {
-        uint16_t value = get_value();
-        return std::string("{") +
-               "\"value\": " + std::to_string(value) +
-               "}";
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
     }
 
     MaskEnableRegister::MaskEnableReg MaskEnableRegister::get_values() const
     {
         MaskEnableReg values;
-        // RW bits
-        if (raw_ & (1 << 15))
-            values.alert_type = AlertType::ShuntOverVoltage;
-        else if (raw_ & (1 << 14))
-            values.alert_type = AlertType::ShuntUnderVoltage;
-        else if (raw_ & (1 << 13))
-            values.alert_type = AlertType::BusOverVoltage;
-        else if (raw_ & (1 << 12))
-            values.alert_type = AlertType::BusUnderVoltage;
-        else if (raw_ & (1 << 11))
-            values.alert_type = AlertType::PowerOverLimit;
-        else
-            values.alert_type = AlertType::None;
+        // RW bits : le premier bit de fonction levé (15..11) détermine le type
+        values.alert_type = AlertType::None;
+        for (uint8_t i = 0; i < static_cast<uint8_t>(AlertType::None); ++i)
+        {
+            if (raw_ & ALERT_TYPE_TABLE[i].mask_bit)
+            {
+                values.alert_type = static_cast<AlertType>(i);
+                break;
+            }
+        }
 
-        values.conversion_ready = raw_ & (1 << 10);
-        values.alert_function_flag = raw_ & (1 << 4);
-        values.conversion_ready_flag = raw_ & (1 << 3);
-        values.math_overflow_flag = raw_ & (1 << 2);
-        values.alert_polarity_bit = raw_ & (1 << 1);
-        values.alert_latch_enable = raw_ & (1 << 0);
+        using R = reg::MaskEnable;
+        values.conversion_ready = R::CNVR::test(raw_);
+        values.alert_function_flag = R::AFF::test(raw_);
+        values.conversion_ready_flag = R::CVRF::test(raw_);
+        values.math_overflow_flag = R::OVF::test(raw_);
+        values.alert_polarity_bit = R::APOL::test(raw_);
+        values.alert_latch_enable = R::LEN::test(raw_);
         return values;
     }
 
     void MaskEnableRegister::set_values(MaskEnableRegister::MaskEnableReg values)
     {
         // Clear tous les bits d’alerte configurables
-        raw_ &= ~((1 << 15) | (1 << 14) | (1 << 13) | (1 << 12) | (1 << 11)); // alert_type bits
-        raw_ &= ~(1 << 10); // CNVR
-        raw_ &= ~(1 << 1);  // APOL
-        raw_ &= ~(1 << 0);  
-        switch (values.alert_type)
-        {
-        case AlertType::ShuntOverVoltage:
-            raw_ |= (1 << 15);
-            break;
-        case AlertType::ShuntUnderVoltage:
-            raw_ |= (1 << 14);
-            break;
-        case AlertType::BusOverVoltage:
-            raw_ |= (1 << 13);
-            break;
-        case AlertType::BusUnderVoltage:
-            raw_ |= (1 << 12);
-            break;
-        case AlertType::PowerOverLimit:
-            raw_ |= (1 << 11);
-            break;
-        case AlertType::None:
-            break;
-        }
-        raw_ |= values.conversion_ready ? (1 << 10) : 0;
-        raw_ |= values.alert_polarity_bit ? (1 << 1) : 0;
-        raw_ |= values.alert_latch_enable ? (1 << 0) : 0;
+        using R = reg::MaskEnable;
+        raw_ &= ~(R::FUNCTIONS | R::CNVR::mask | R::APOL::mask | R::LEN::mask);
+        raw_ |= alert_type_info(values.alert_type).mask_bit;
+        raw_ = R::CNVR::set(raw_, values.conversion_ready);
+        raw_ = R::APOL::set(raw_, values.alert_polarity_bit);
+        raw_ = R::LEN::set(raw_, values.alert_latch_enable);
     }
 
     void MaskEnableRegister::log() const
@@ -154,30 +147,8 @@ namespace ina226
 
         ESP_LOGI(TAG, "Register (0x06) = 0x%04X", raw_);
 
-        const char *type_str = nullptr;
-        switch (v.alert_type)
-        {
-        case AlertType::ShuntOverVoltage:
-            type_str = "Shunt Over Voltage";
-            break;
-        case AlertType::ShuntUnderVoltage:
-            type_str = "Shunt Under Voltage";
-            break;
-        case AlertType::BusOverVoltage:
-            type_str = "Bus Over Voltage";
-            break;
-        case AlertType::BusUnderVoltage:
-            type_str = "Bus Under Voltage";
-            break;
-        case AlertType::PowerOverLimit:
-            type_str = "Power Over Limit";
-            break;
-        case AlertType::None:
-            type_str = "None";
-            break;
-        }
-
-        ESP_LOGI(TAG, "Alert Type             : %s", type_str);
+        std::string_view type_str = alert_type_info(v.alert_type).label;
+        ESP_LOGI(TAG, "Alert Type             : %.*s", static_cast<int>(type_str.size()), type_str.data());
         ESP_LOGI(TAG, "CNVR (Conv Ready En)   : %s", v.conversion_ready ? "true" : "false");
         ESP_LOGI(TAG, "AFF  (Alert Flag)      : %s", v.alert_function_flag ? "true" : "false");
         ESP_LOGI(TAG, "CVRF (Conv Ready F)    : %s", v.conversion_ready_flag ? "true" : "false");
@@ -186,43 +157,24 @@ namespace ina226
         ESP_LOGI(TAG, "LEN  (Latch Enable)    : %s", v.alert_latch_enable ? "true" : "false");
     }
 
-    std::string MaskEnableRegister::to_json() const
+    size_t MaskEnableRegister::to_json(char *buf, size_t len) const
     {
         auto v = get_values();
+        std::string_view type_str = alert_type_info(v.alert_type).key;
+        return format_to(buf, len,
+                         "{\"value\": %u,\"alert_type\": \"%.*s\",\"CNVR\": %s,\"AFF\": %s,"
+                         "\"CVRF\": %s,\"OVF\": %s,\"APOL\": %s,\"LEN\": %s}",
+                         raw_, static_cast<int>(type_str.size()), type_str.data(),
+                         bool_str(v.conversion_ready), bool_str(v.alert_function_flag),
+                         bool_str(v.conversion_ready_flag), bool_str(v.math_overflow_flag),
+                         bool_str(v.alert_polarity_bit), bool_str(v.alert_latch_enable));
+    }
 
-        const char *type_str = nullptr;
-        switch (v.alert_type)
-        {
-        case AlertType::ShuntOverVoltage:
-            type_str = "shunt_over_voltage";
-            break;
-        case AlertType::ShuntUnderVoltage:
-            type_str = "shunt_under_voltage";
-            break;
-        case AlertType::BusOverVoltage:
-            type_str = "bus_over_voltage";
-            break;
-        case AlertType::BusUnderVoltage:
-            type_str = "bus_under_voltage";
-            break;
-        case AlertType::PowerOverLimit:
-            type_str = "power_over_limit";
-            break;
-        case AlertType::None:
-            type_str = "none";
-            break;
-        }
-
-        return std::string("{") +
-               "\"value\": " + std::to_string(raw_) + "," +
-               "\"alert_type\": \"" + type_str + "\"," +
-               "\"CNVR\": " + (v.conversion_ready ? "true" : "false") + "," +
-               "\"AFF\": " + (v.alert_function_flag ? "true" : "false") + "," +
-               "\"CVRF\": " + (v.conversion_ready_flag ? "true" : "false") + "," +
-               "\"OVF\": " + (v.math_overflow_flag ? "true" : "false") + "," +
-               "\"APOL\": " + (v.alert_polarity_bit ? "true" : "false") + "," +
-               "\"LEN\": " + (v.alert_latch_enable ? "true" : "false") +
-               "}";
+    std::string MaskEnableRegister::to_json() const
+    {
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
     }
 
     uint32_t AlertLimitRegister::get_value() const
@@ -271,44 +223,23 @@ namespace ina226
 
     void AlertLimitRegister::log() const
     {
-        const char *type_str = nullptr;
-        switch (type_)
-        {
-            case AlertType::ShuntOverVoltage:
-            case AlertType::ShuntUnderVoltage:
-                type_str = "Shunt (µV)";
-                break;
-            case AlertType::BusOverVoltage:
-            case AlertType::BusUnderVoltage:
-                type_str = "Bus (mV)";
-                break;
-            case AlertType::PowerOverLimit:
-                type_str = "Power (mW)";
-                break;
-            case AlertType::None:
-                type_str = "None";
-                break;
-        }
-        ESP_LOGI(TAG, "Alert Limit Register (0x07): %s = %u (converted), raw = 0x%04X", type_str, get_value(), raw_);
+        std::string_view type_str = alert_type_info(type_).limit_unit;
+        ESP_LOGI(TAG, "Alert Limit Register (0x07): %.*s = %u (converted), raw = 0x%04X",
+                 static_cast<int>(type_str.size()), type_str.data(), get_value(), raw_);
+    }
+
+    size_t AlertLimitRegister::to_json(char *buf, size_t len) const
+    {
+        std::string_view type_str = alert_type_info(type_).name;
+        return format_to(buf, len, "{\"type\": \"%.*s\",\"value\": %" PRIu32 ",\"raw_register\": %u}",
+                         static_cast<int>(type_str.size()), type_str.data(), get_value(), raw_);
     }
 
     std::string AlertLimitRegister::to_json() const
     {
-        const char *type_str = nullptr;
-        switch (type_)
-        {
-            case AlertType::ShuntOverVoltage:   type_str = "ShuntOverVoltage"; break;
-            case AlertType::ShuntUnderVoltage:  type_str = "ShuntUnderVoltage"; break;
-            case AlertType::BusOverVoltage:     type_str = "BusOverVoltage"; break;
-            case AlertType::BusUnderVoltage:    type_str = "BusUnderVoltage"; break;
-            case AlertType::PowerOverLimit:     type_str = "PowerOverLimit"; break;
-            case AlertType::None:               type_str = "None"; break;
-        }
-        return std::string("{") +
-               "\"type\": \"" + type_str + "\"," +
-               "\"value\": " + std::to_string(get_value()) + "," +
-               "\"raw_register\": " + std::to_string(raw_) +
-               "}";
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
     }
 
     void ConfigParams::log() const
@@ -319,14 +250,25 @@ namespace ina226
         alert_limit.log();
     }
 
+    size_t ConfigParams::to_json(char *buf, size_t len) const
+    {
+        size_t n = format_to(buf, len, "{\"configuration\": ");
+        n += configuration.to_json(buf + n, len - n);
+        n += format_to(buf + n, len - n, ",\"calibration\": ");
+        n += calibration.to_json(buf + n, len - n);
+        n += format_to(buf + n, len - n, ",\"alert_mask\": ");
+        n += alert_mask.to_json(buf + n, len - n);
+        n += format_to(buf + n, len - n, ",\"alert_limit\": ");
+        n += alert_limit.to_json(buf + n, len - n);
+        n += format_to(buf + n, len - n, "}");
+        return n;
+    }
+
     std::string ConfigParams::to_json() const
     {
-        return std::string("{") +
-               "\"configuration\": " + configuration.to_json() + "," +
-               "\"calibration\": " + calibration.to_json() + "," +
-               "\"alert_mask\": " + alert_mask.to_json() + "," +
-               "\"alert_limit\": " + alert_limit.to_json() +
-               "}";
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
     }
 
 }
\ No newline at end of file
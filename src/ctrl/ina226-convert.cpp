@@ -0,0 +1,102 @@
+#include "ctrl/ina226-convert.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ina226
+{
+    ConversionScale ConversionScale::from_current_lsb_na(uint32_t current_lsb_na)
+    {
+        ConversionScale s;
+        s.current_ma_per_lsb = current_lsb_na * 1e-6f;
+        s.power_mw_per_lsb = 25.0f * s.current_ma_per_lsb;
+        return s;
+    }
+
+    ConversionScale ConversionScale::from_calibration(uint16_t calibration_raw, uint16_t shunt_res_milliohm)
+    {
+        return from_current_lsb_na(current_lsb_na(calibration_raw, shunt_res_milliohm));
+    }
+
+    void convert_s16(const int16_t *__restrict raw, float *__restrict out, size_t count, float scale)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        const __m128 k = _mm_set1_ps(scale);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(raw + i));
+            // Extension de signe 16 → 32 bits : duplication puis décalage arithmétique
+            __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+            __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), k));
+            _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), k));
+        }
+#endif
+        for (; i < count; ++i)
+            out[i] = static_cast<float>(raw[i]) * scale;
+    }
+
+    void convert_u16(const uint16_t *__restrict raw, float *__restrict out, size_t count, float scale)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        const __m128 k = _mm_set1_ps(scale);
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(raw + i));
+            __m128i lo = _mm_unpacklo_epi16(v, zero);
+            __m128i hi = _mm_unpackhi_epi16(v, zero);
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), k));
+            _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), k));
+        }
+#endif
+        for (; i < count; ++i)
+            out[i] = static_cast<float>(raw[i]) * scale;
+    }
+
+    void convert_samples(const RawSample *in, Measurement *out, size_t count, const ConversionScale &s)
+    {
+        // Paquets de taille fixe sur la pile : pas d'allocation, reste en cache L1
+        constexpr size_t CHUNK = 64;
+        int16_t shunt[CHUNK], current[CHUNK];
+        uint16_t bus[CHUNK], power[CHUNK];
+        float shunt_f[CHUNK], bus_f[CHUNK], current_f[CHUNK], power_f[CHUNK];
+
+        for (size_t base = 0; base < count; base += CHUNK)
+        {
+            const size_t n = (count - base < CHUNK) ? count - base : CHUNK;
+            for (size_t i = 0; i < n; ++i)
+            {
+                shunt[i] = in[base + i].shunt;
+                bus[i] = in[base + i].bus;
+                power[i] = in[base + i].power;
+                current[i] = in[base + i].current;
+            }
+
+            convert_shunt_uv(shunt, shunt_f, n, s);
+            convert_bus_mv(bus, bus_f, n, s);
+            convert_current_ma(current, current_f, n, s);
+            convert_power_mw(power, power_f, n, s);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                Measurement &m = out[base + i];
+                m.timestamp_us = in[base + i].timestamp_us;
+                m.shunt_uv = shunt_f[i];
+                m.bus_mv = bus_f[i];
+                m.current_ma = current_f[i];
+                m.power_mw = power_f[i];
+            }
+        }
+    }
+
+    void convert_samples_scalar(const RawSample *in, Measurement *out, size_t count, const ConversionScale &s)
+    {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = convert_sample(in[i], s);
+    }
+
+} // namespace ina226
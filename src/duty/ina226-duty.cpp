@@ -0,0 +1,204 @@
+#include "duty/ina226-duty.hpp"
+
+#include <cinttypes>
+
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "esp_sleep.h"
+#endif
+
+#include "ina226-error.hpp"
+
+namespace ina226
+{
+    float DutyCycleStats::sensor_energy_uj_per_sample(const EnergyModel &m) const
+    {
+        if (samples == 0)
+            return 0.0f;
+        // µA × µs × V = pJ
+        const double idle_us = static_cast<double>(elapsed_us - active_us);
+        const double pj = m.supply_v * (m.active_current_ua * active_us + m.shutdown_current_ua * idle_us);
+        return static_cast<float>(pj / 1e6 / samples);
+    }
+
+    float DutyCycleStats::bus_energy_uj_per_sample(const EnergyModel &m) const
+    {
+        if (samples == 0 || m.i2c_frequency_hz == 0 || m.pullup_ohm <= 0.0f)
+            return 0.0f;
+        // Une ligne tirée à la masse dissipe V² / R ; SCL et SDA sont en moyenne basses
+        // chacune la moitié du temps, soit l'équivalent d'une ligne pendant toute la transaction.
+        const double bus_s = static_cast<double>(i2c_transactions) * BITS_PER_TRANSACTION / m.i2c_frequency_hz;
+        const double joules = bus_s * m.supply_v * m.supply_v / m.pullup_ohm;
+        return static_cast<float>(joules * 1e6 / samples);
+    }
+
+    esp_err_t DutyCycleScheduler::start(const DutyCycleConfig &config)
+    {
+        config_ = config;
+        if (config_.burst_count == 0)
+            config_.burst_count = 1;
+
+        RETURN_IF_ERROR(cfg_.get_config());
+        RETURN_IF_ERROR(cfg_.get_calibration());
+        scale_ = ConversionScale::from_calibration(cfg_.datas().calibration.get_value(),
+                                                   CONFIG_INA226_SHUNT_RESISTANCE_MILLIOHM);
+
+        ConfigurationRegister &reg = cfg_.datas().configuration;
+        saved_raw_ = reg.get_raw();
+
+        ConfigurationRegister::ConfigurationReg values = reg.get_values();
+        values.mode = ConfigurationRegister::OperatingMode::ShuntAndBusTriggered;
+        reg.set_values(values);
+        trigger_raw_ = reg.get_raw();
+        period_us_ = reg.conversion_period_us();
+
+        values.mode = ConfigurationRegister::OperatingMode::PowerDown;
+        reg.set_values(values);
+        park_raw_ = reg.get_raw();
+
+        stats_ = {};
+        RETURN_IF_ERROR(write_config(park_raw_));
+        started_us_ = esp_timer_get_time();
+        next_cycle_us_ = started_us_;
+        return ESP_OK;
+    }
+
+    esp_err_t DutyCycleScheduler::write_config(uint16_t raw)
+    {
+        cfg_.datas().configuration.set_raw(raw);
+        ++stats_.i2c_transactions;
+        return cfg_.set_config();
+    }
+
+    esp_err_t DutyCycleScheduler::wait_ready(int64_t ready_us, int64_t deadline_us)
+    {
+        // Reste de la conversion nominale que sleep_until() n'a pas couvert (moins d'un tick),
+        // arrondi au tick supérieur : pas de lecture de 0x06 avant la fin théorique
+        const int64_t tick_us = static_cast<int64_t>(portTICK_PERIOD_MS) * 1000;
+        const int64_t remaining_us = ready_us - esp_timer_get_time();
+        if (remaining_us > 0)
+            vTaskDelay(static_cast<TickType_t>((remaining_us + tick_us - 1) / tick_us));
+
+        while (true)
+        {
+            // Lecture dans une variable locale : l'image du masque dans cfg_ reste celle de l'utilisateur
+            uint16_t mask = 0;
+            ++stats_.i2c_transactions;
+            RETURN_IF_ERROR(cfg_.read<reg::MaskEnable>(mask));
+            if (reg::MaskEnable::CVRF::test(mask))
+                return ESP_OK;
+            if (esp_timer_get_time() > deadline_us)
+                return ESP_ERR_TIMEOUT;
+            // Conversion plus longue que prévu : on rend la main un tick entre deux lectures
+            vTaskDelay(1);
+        }
+    }
+
+    void DutyCycleScheduler::sleep_until(int64_t wake_us)
+    {
+        const int64_t now = esp_timer_get_time();
+        const int64_t delay_us = wake_us - now;
+        if (delay_us <= 0)
+            return;
+
+#if !CONFIG_IDF_TARGET_LINUX
+        if (config_.light_sleep && delay_us >= LIGHT_SLEEP_MIN_US)
+        {
+            esp_sleep_enable_timer_wakeup(static_cast<uint64_t>(delay_us));
+            if (esp_light_sleep_start() == ESP_OK)
+            {
+                stats_.sleep_us += esp_timer_get_time() - now;
+                return;
+            }
+        }
+#endif
+        const TickType_t ticks = pdMS_TO_TICKS(delay_us / 1000);
+        if (ticks > 0)
+            vTaskDelay(ticks);
+    }
+
+    esp_err_t DutyCycleScheduler::sample(Measurement &out)
+    {
+        const int64_t t0 = esp_timer_get_time();
+        RETURN_IF_ERROR(write_config(trigger_raw_));
+
+        // Le composant convertit pendant que l'ESP dort
+        sleep_until(t0 + period_us_);
+
+        // Marge d'une période et d'un tick de scrutation au-delà de la durée nominale
+        const int64_t ready_us = t0 + period_us_;
+        const int64_t margin_us = static_cast<int64_t>(period_us_) + 1000 + portTICK_PERIOD_MS * 1000;
+        esp_err_t err = wait_ready(ready_us, ready_us + margin_us);
+        RawSample raw;
+        if (err == ESP_OK)
+        {
+            stats_.i2c_transactions += 4;
+            err = ctrl_.get_raw(raw);
+        }
+
+        // Retour en Power-Down quoi qu'il arrive
+        esp_err_t park = write_config(park_raw_);
+        stats_.active_us += esp_timer_get_time() - t0;
+        RETURN_IF_ERROR(err);
+        RETURN_IF_ERROR(park);
+
+        raw.timestamp_us = t0;
+        out = convert_sample(raw, scale_);
+        ++stats_.samples;
+        return ESP_OK;
+    }
+
+    esp_err_t DutyCycleScheduler::run_cycle(Measurement *out, size_t max, size_t &count)
+    {
+        count = 0;
+        const size_t burst = config_.burst_count < max ? config_.burst_count : max;
+        const int64_t cycle_start = next_cycle_us_;
+
+        esp_err_t err = ESP_OK;
+        for (size_t i = 0; i < burst; ++i)
+        {
+            if (i > 0 && config_.burst_interval_ms > 0)
+                sleep_until(cycle_start + static_cast<int64_t>(i) * config_.burst_interval_ms * 1000);
+            err = sample(out[count]);
+            if (err != ESP_OK)
+                break;
+            ++count;
+        }
+
+        ++stats_.cycles;
+        next_cycle_us_ = cycle_start + static_cast<int64_t>(config_.period_ms) * 1000;
+        // Cycle en retard (rafale trop longue) : on repart de maintenant plutôt que d'enchaîner
+        const int64_t now = esp_timer_get_time();
+        if (next_cycle_us_ < now)
+            next_cycle_us_ = now;
+        sleep_until(next_cycle_us_);
+
+        stats_.elapsed_us = esp_timer_get_time() - started_us_;
+        return err;
+    }
+
+    esp_err_t DutyCycleScheduler::stop()
+    {
+        stats_.elapsed_us = esp_timer_get_time() - started_us_;
+        return write_config(saved_raw_);
+    }
+
+    void DutyCycleScheduler::log() const
+    {
+        ESP_LOGI(TAG, "Période %u ms, rafale %u, conversion %u µs",
+                 static_cast<unsigned>(config_.period_ms), static_cast<unsigned>(config_.burst_count),
+                 static_cast<unsigned>(period_us_));
+        ESP_LOGI(TAG, "%u mesures / %u cycles, rapport cyclique %.4f %%, light sleep %" PRId64 " ms",
+                 static_cast<unsigned>(stats_.samples), static_cast<unsigned>(stats_.cycles),
+                 stats_.duty_cycle() * 100.0f, stats_.sleep_us / 1000);
+        ESP_LOGI(TAG, "Énergie par mesure : capteur %.3f µJ, bus I2C %.3f µJ",
+                 stats_.sensor_energy_uj_per_sample(config_.energy),
+                 stats_.bus_energy_uj_per_sample(config_.energy));
+    }
+
+} // namespace ina226
@@ -0,0 +1,226 @@
+#include "health/ina226-health.hpp"
+
+#include <cinttypes>
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ina226-clock.hpp"
+#include "ina226-error.hpp"
+
+namespace ina226
+{
+    HealthMonitor::HealthMonitor(Config &cfg, CTRL &ctrl, HealthConfig config)
+        : cfg_(cfg),
+          ctrl_(ctrl),
+          config_(config)
+    {
+    }
+
+    void HealthMonitor::start(int64_t now_us)
+    {
+        // Les fronts ne rythment les conversions que si CNVR est actif
+        expect_edges_ = cfg_.datas().alert_mask.get_values().conversion_ready && period_us() > 0;
+        last_sample_us_ = now_us;
+        identical_ = 0;
+        bus_errors_ = 0;
+        fault_ = HealthFault::None;
+    }
+
+    uint32_t HealthMonitor::period_us() const
+    {
+        return cfg_.datas().configuration.conversion_period_us();
+    }
+
+    uint32_t HealthMonitor::edge_timeout_ms() const
+    {
+        if (!expect_edges_ || config_.missing_edge_periods == 0)
+            return 0;
+        const uint64_t ms = static_cast<uint64_t>(period_us()) * config_.missing_edge_periods / 1000;
+        return ms ? static_cast<uint32_t>(ms) : 1;
+    }
+
+    void HealthMonitor::raise(HealthFault fault, int64_t now_us)
+    {
+        if (fault_ != HealthFault::None)
+            return;
+        fault_ = fault;
+        fault_since_us_ = now_us;
+        last_attempt_us_ = 0;
+        ++stats_.faults[static_cast<size_t>(fault)];
+        std::string_view name = to_string(fault);
+        ESP_LOGW(TAG, "Défaut détecté : %.*s", static_cast<int>(name.size()), name.data());
+    }
+
+    void HealthMonitor::clear(int64_t now_us)
+    {
+        stats_.time_to_recover.add(now_us - fault_since_us_);
+        fault_ = HealthFault::None;
+        last_sample_us_ = now_us;
+        identical_ = 0;
+        bus_errors_ = 0;
+    }
+
+    void HealthMonitor::on_sample(const RawSample &raw, uint16_t mask_enable)
+    {
+        last_sample_us_ = raw.timestamp_us;
+        bus_errors_ = 0;
+
+        // Une lecture réussie suffit à lever un défaut de bus ou d'absence de front
+        if (fault_ == HealthFault::BusError || fault_ == HealthFault::MissingEdge)
+            clear(raw.timestamp_us);
+
+        const bool same = raw.shunt == last_raw_.shunt && raw.bus == last_raw_.bus &&
+                          raw.power == last_raw_.power && raw.current == last_raw_.current;
+        identical_ = same ? identical_ + 1 : 0;
+        last_raw_ = raw;
+
+        if (config_.frozen_samples && identical_ >= config_.frozen_samples)
+            raise(HealthFault::FrozenValue, raw.timestamp_us);
+        if (reg::MaskEnable::OVF::test(mask_enable))
+            raise(HealthFault::MathOverflow, raw.timestamp_us);
+    }
+
+    void HealthMonitor::on_bus_error(esp_err_t err)
+    {
+        if (err == ESP_OK)
+            return;
+        if (++bus_errors_ >= config_.bus_error_threshold)
+            raise(HealthFault::BusError, clock::now_us());
+    }
+
+    HealthFault HealthMonitor::check(int64_t now_us)
+    {
+        const uint32_t timeout_ms = edge_timeout_ms();
+        if (fault_ == HealthFault::None && timeout_ms &&
+            now_us - last_sample_us_ > static_cast<int64_t>(timeout_ms) * 1000)
+            raise(HealthFault::MissingEdge, now_us);
+        return fault_;
+    }
+
+    esp_err_t HealthMonitor::verify()
+    {
+        uint16_t mask = 0;
+        switch (fault_)
+        {
+        case HealthFault::BusError:
+            return ctrl_.ready();
+
+        case HealthFault::MathOverflow:
+            RETURN_IF_ERROR(ctrl_.read<reg::MaskEnable>(mask));
+            return reg::MaskEnable::OVF::test(mask) ? ESP_FAIL : ESP_OK;
+
+        case HealthFault::MissingEdge:
+        case HealthFault::FrozenValue:
+        {
+            // Le composant convertit-il encore ? CVRF doit se lever en au plus deux périodes.
+            // Des valeurs figées mais fraîches (charge stable) sont ainsi acceptées dès la relecture.
+            const TickType_t wait = pdMS_TO_TICKS(period_us() / 1000) + 1;
+            for (int i = 0; i < 2; ++i)
+            {
+                vTaskDelay(wait);
+                RETURN_IF_ERROR(ctrl_.read<reg::MaskEnable>(mask));
+                if (reg::MaskEnable::CVRF::test(mask))
+                    return ESP_OK;
+            }
+            return ESP_ERR_TIMEOUT;
+        }
+
+        case HealthFault::None:
+        default:
+            return ESP_OK;
+        }
+    }
+
+    esp_err_t HealthMonitor::reapply_and_verify()
+    {
+        const ConfigParams &p = cfg_.datas();
+        RETURN_IF_ERROR(cfg_.set());
+
+        reg::Snapshot<reg::Configuration, reg::Calibration, reg::MaskEnable, reg::AlertLimit> regs;
+        RETURN_IF_ERROR(ctrl_.read_many(regs));
+
+        // Bit 15 (reset) se relit à 0 ; seuls les bits inscriptibles de Mask/Enable comptent
+        constexpr uint16_t CONFIG_BITS = static_cast<uint16_t>(~reg::Configuration::RST::mask);
+        constexpr uint16_t MASK_BITS = reg::MaskEnable::WRITABLE;
+        if ((regs.get<reg::Configuration>() & CONFIG_BITS) != (p.configuration.get_raw() & CONFIG_BITS) ||
+            regs.get<reg::Calibration>() != p.calibration.get_raw() ||
+            (regs.get<reg::MaskEnable>() & MASK_BITS) != (p.alert_mask.get_raw() & MASK_BITS) ||
+            regs.get<reg::AlertLimit>() != p.alert_limit.get_raw())
+        {
+            ESP_LOGW(TAG, "Relecture de la configuration différente de la référence");
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        return ESP_OK;
+    }
+
+    esp_err_t HealthMonitor::run_step(RecoveryStep step)
+    {
+        switch (step)
+        {
+        case RecoveryStep::Reread:
+            break;
+        case RecoveryStep::Reapply:
+            RETURN_IF_ERROR(reapply_and_verify());
+            break;
+        case RecoveryStep::SoftReset:
+            RETURN_IF_ERROR(ctrl_.send_reset());
+            vTaskDelay(1);
+            RETURN_IF_ERROR(reapply_and_verify());
+            break;
+        default:
+            return ESP_ERR_INVALID_ARG;
+        }
+        return verify();
+    }
+
+    esp_err_t HealthMonitor::recover()
+    {
+        if (fault_ == HealthFault::None)
+            return ESP_OK;
+
+        const int64_t now = clock::now_us();
+        if (last_attempt_us_ && now - last_attempt_us_ < static_cast<int64_t>(config_.retry_interval_ms) * 1000)
+            return ESP_ERR_INVALID_STATE;
+
+        for (uint8_t s = 0; s < static_cast<uint8_t>(RecoveryStep::COUNT); ++s)
+        {
+            const RecoveryStep step = static_cast<RecoveryStep>(s);
+            if (run_step(step) == ESP_OK)
+            {
+                ++stats_.recovered_by[s];
+                const int64_t done = clock::now_us();
+                std::string_view name = to_string(step);
+                ESP_LOGI(TAG, "Reprise par %.*s en %" PRId64 " µs", static_cast<int>(name.size()), name.data(),
+                         done - fault_since_us_);
+                clear(done);
+                return ESP_OK;
+            }
+        }
+
+        ++stats_.failed_recoveries;
+        last_attempt_us_ = clock::now_us();
+        ESP_LOGE(TAG, "Reprise impossible, nouvel essai dans %u ms", static_cast<unsigned>(config_.retry_interval_ms));
+        return ESP_FAIL;
+    }
+
+    void HealthMonitor::log() const
+    {
+        for (uint8_t f = 1; f < static_cast<uint8_t>(HealthFault::COUNT); ++f)
+        {
+            std::string_view name = to_string(static_cast<HealthFault>(f));
+            ESP_LOGI(TAG, "%-14.*s : %u", static_cast<int>(name.size()), name.data(), static_cast<unsigned>(stats_.faults[f]));
+        }
+        for (uint8_t s = 0; s < static_cast<uint8_t>(RecoveryStep::COUNT); ++s)
+        {
+            std::string_view name = to_string(static_cast<RecoveryStep>(s));
+            ESP_LOGI(TAG, "Repris par %-10.*s : %u", static_cast<int>(name.size()), name.data(),
+                     static_cast<unsigned>(stats_.recovered_by[s]));
+        }
+        const TimingStats &t = stats_.time_to_recover;
+        ESP_LOGI(TAG, "Échecs de reprise : %u, MTTR %" PRId64 " µs (max %" PRId64 " µs, n=%u)",
+                 static_cast<unsigned>(stats_.failed_recoveries), t.mean_us(), t.max_us, static_cast<unsigned>(t.count));
+    }
+
+} // namespace ina226
@@ -0,0 +1,231 @@
+#include "history/ina226-history.hpp"
+
+#include <cinttypes>
+#include <cstring>
+
+#include "esp_log.h"
+
+#include "ina226-format.hpp"
+
+namespace ina226
+{
+    static const char *TAG = "INA226-HISTORY";
+
+    void HistorySummary::add(int64_t start, int64_t end, uint32_t n, float mn, float mx, double sum_mw, double e_mj)
+    {
+        if (!n)
+            return;
+        if (!count)
+        {
+            start_us = start;
+            min_mw = mn;
+            max_mw = mx;
+        }
+        end_us = end;
+        if (mn < min_mw)
+            min_mw = mn;
+        if (mx > max_mw)
+            max_mw = mx;
+        mean_mw = static_cast<float>((static_cast<double>(mean_mw) * count + sum_mw) / (count + n));
+        count += n;
+        energy_mj += e_mj;
+        ++buckets;
+    }
+
+    void HistorySummary::log() const
+    {
+        if (!resolution_s)
+        {
+            ESP_LOGI(TAG, "Aucune donnée sur la plage");
+            return;
+        }
+        ESP_LOGI(TAG, "%" PRId64 " → %" PRId64 " µs (%" PRIu32 " × %" PRIu32 " s, %llu échantillons)", start_us, end_us,
+                 buckets, resolution_s, static_cast<unsigned long long>(count));
+        ESP_LOGI(TAG, "Puissance : min %.1f, moy %.1f, max %.1f mW ; énergie %.3f J", min_mw, mean_mw, max_mw,
+                 energy_mj / 1000.0);
+    }
+
+    size_t HistorySummary::to_json(char *buf, size_t len) const
+    {
+        return format_to(buf, len,
+                         "{\"start_us\": %" PRId64 ",\"end_us\": %" PRId64 ",\"resolution_s\": %" PRIu32
+                         ",\"buckets\": %" PRIu32 ",\"count\": %llu,\"power_mw\": {\"min\": %.2f,\"mean\": %.2f,"
+                         "\"max\": %.2f},\"energy_mj\": %.3f}",
+                         start_us, end_us, resolution_s, buckets, static_cast<unsigned long long>(count), min_mw,
+                         mean_mw, max_mw, energy_mj);
+    }
+
+    std::string HistorySummary::to_json() const
+    {
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
+    }
+
+    /// Verrou de portée sur le mutex FreeRTOS de HistoryStore
+    class HistoryLock
+    {
+    public:
+        explicit HistoryLock(SemaphoreHandle_t mutex) : mutex_(mutex) { xSemaphoreTake(mutex_, portMAX_DELAY); }
+        ~HistoryLock() { xSemaphoreGive(mutex_); }
+        HistoryLock(const HistoryLock &) = delete;
+        HistoryLock &operator=(const HistoryLock &) = delete;
+
+    private:
+        SemaphoreHandle_t mutex_;
+    };
+
+    HistoryStore::HistoryStore(uint32_t max_gap_s)
+        : max_gap_us_(static_cast<int64_t>(max_gap_s) * 1000000),
+          lock_(xSemaphoreCreateMutexStatic(&lock_buf_))
+    {
+    }
+
+    void HistoryStore::add(const Measurement &m)
+    {
+        HistoryLock lock(lock_);
+        if (rebase_)
+        {
+            // Première mesure après load() : reprise à la dernière mesure sauvegardée
+            offset_us_ = last_us_ - m.timestamp_us;
+            rebase_ = false;
+            has_last_ = false;
+        }
+        const int64_t t_us = m.timestamp_us + offset_us_;
+        double energy_mj = 0.0;
+        if (has_last_)
+        {
+            const int64_t dt_us = t_us - last_us_;
+            if (dt_us > 0 && dt_us <= max_gap_us_)
+                energy_mj = 0.5 * (static_cast<double>(m.power_mw) + last_mw_) * dt_us * 1e-6;
+        }
+        seconds_.add(t_us, m.power_mw, energy_mj);
+        minutes_.add(t_us, m.power_mw, energy_mj);
+        hours_.add(t_us, m.power_mw, energy_mj);
+        last_us_ = t_us;
+        last_mw_ = m.power_mw;
+        has_last_ = true;
+    }
+
+    HistoryStore::Resolution HistoryStore::pick(int64_t from_us, int64_t to_us, size_t max_points) const
+    {
+        if (seconds_.covers(from_us) && seconds_.span(from_us, to_us) <= max_points)
+            return Resolution::Second;
+        if (minutes_.covers(from_us) && minutes_.span(from_us, to_us) <= max_points)
+            return Resolution::Minute;
+        return Resolution::Hour;
+    }
+
+    HistorySummary HistoryStore::query(int64_t from_us, int64_t to_us, Resolution res) const
+    {
+        HistoryLock lock(lock_);
+        HistorySummary out;
+        if (res == Resolution::Auto)
+            res = pick(from_us, to_us, SIZE_MAX);
+        switch (res)
+        {
+        case Resolution::Second:
+            seconds_.query(from_us, to_us, out);
+            break;
+        case Resolution::Minute:
+            minutes_.query(from_us, to_us, out);
+            break;
+        default:
+            hours_.query(from_us, to_us, out);
+            break;
+        }
+        if (!out.count)
+            out.resolution_s = 0;
+        return out;
+    }
+
+    HistorySummary HistoryStore::last(uint32_t seconds) const
+    {
+        const int64_t to = last_us() + 1;
+        return query(to - static_cast<int64_t>(seconds) * 1000000, to);
+    }
+
+    size_t HistoryStore::series(int64_t from_us, int64_t to_us, HistoryPoint *out, size_t max, Resolution res) const
+    {
+        HistoryLock lock(lock_);
+        if (res == Resolution::Auto)
+            res = pick(from_us, to_us, max);
+        switch (res)
+        {
+        case Resolution::Second:
+            return seconds_.series(from_us, to_us, out, max);
+        case Resolution::Minute:
+            return minutes_.series(from_us, to_us, out, max);
+        default:
+            return hours_.series(from_us, to_us, out, max);
+        }
+    }
+
+    int64_t HistoryStore::last_us() const
+    {
+        HistoryLock lock(lock_);
+        return last_us_;
+    }
+
+    int64_t HistoryStore::offset_us() const
+    {
+        HistoryLock lock(lock_);
+        return offset_us_;
+    }
+
+    // Image : profondeurs (3 × u32), dernière mesure (i64), puis les trois anneaux tels quels
+    size_t HistoryStore::save(uint8_t *buf, size_t len) const
+    {
+        if (len < SNAPSHOT_SIZE)
+            return 0;
+        const uint32_t depths[] = {static_cast<uint32_t>(Seconds::SLOTS), static_cast<uint32_t>(Minutes::SLOTS),
+                                   static_cast<uint32_t>(Hours::SLOTS)};
+        HistoryLock lock(lock_);
+        std::memcpy(buf, depths, 12);
+        std::memcpy(buf + 12, &last_us_, 8);
+        size_t n = 20;
+        std::memcpy(buf + n, &seconds_, sizeof(seconds_));
+        n += sizeof(seconds_);
+        std::memcpy(buf + n, &minutes_, sizeof(minutes_));
+        n += sizeof(minutes_);
+        std::memcpy(buf + n, &hours_, sizeof(hours_));
+        return SNAPSHOT_SIZE;
+    }
+
+    esp_err_t HistoryStore::load(const uint8_t *buf, size_t len)
+    {
+        if (len != SNAPSHOT_SIZE)
+            return ESP_ERR_INVALID_SIZE;
+        uint32_t depths[3];
+        std::memcpy(depths, buf, 12);
+        if (depths[0] != Seconds::SLOTS || depths[1] != Minutes::SLOTS || depths[2] != Hours::SLOTS)
+            return ESP_ERR_INVALID_SIZE;
+
+        HistoryLock lock(lock_);
+        std::memcpy(&last_us_, buf + 12, 8);
+        size_t n = 20;
+        std::memcpy(static_cast<void *>(&seconds_), buf + n, sizeof(seconds_));
+        n += sizeof(seconds_);
+        std::memcpy(static_cast<void *>(&minutes_), buf + n, sizeof(minutes_));
+        n += sizeof(minutes_);
+        std::memcpy(static_cast<void *>(&hours_), buf + n, sizeof(hours_));
+        offset_us_ = 0;
+        has_last_ = false;
+        rebase_ = true;
+        return ESP_OK;
+    }
+
+    void HistoryStore::reset()
+    {
+        HistoryLock lock(lock_);
+        seconds_.reset();
+        minutes_.reset();
+        hours_.reset();
+        last_us_ = 0;
+        last_mw_ = 0.0f;
+        has_last_ = false;
+        offset_us_ = 0;
+        rebase_ = false;
+    }
+
+} // namespace ina226
@@ -0,0 +1,83 @@
+#include "ina226-alloc_guard.hpp"
+#include "sdkconfig.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace ina226
+{
+    namespace alloc_guard
+    {
+        static std::atomic<uint32_t> s_count{0};
+        static std::atomic<uint32_t> s_violations{0};
+        static std::atomic<bool> s_armed{false};
+        static std::atomic<bool> s_fatal{false};
+
+        void arm(bool fatal)
+        {
+            s_fatal = fatal;
+            s_armed = true;
+        }
+
+        void disarm() { s_armed = false; }
+        bool armed() { return s_armed; }
+        uint32_t count() { return s_count; }
+        uint32_t violations() { return s_violations; }
+
+#if CONFIG_INA226_ALLOC_GUARD
+        static void *counted_alloc(size_t size)
+        {
+            s_count.fetch_add(1, std::memory_order_relaxed);
+            if (s_armed.load(std::memory_order_relaxed))
+            {
+                s_violations.fetch_add(1, std::memory_order_relaxed);
+                if (s_fatal.load(std::memory_order_relaxed))
+                {
+                    // Pas de log formaté ici : il pourrait lui-même allouer
+                    fputs("INA226 alloc_guard: heap allocation after initialization\n", stderr);
+                    abort();
+                }
+            }
+            return malloc(size ? size : 1);
+        }
+#endif
+    } // namespace alloc_guard
+} // namespace ina226
+
+#if CONFIG_INA226_ALLOC_GUARD
+void *operator new(size_t size)
+{
+    void *p = ina226::alloc_guard::counted_alloc(size);
+    if (!p)
+    {
+#if __cpp_exceptions
+        throw std::bad_alloc();
+#else
+        abort();
+#endif
+    }
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return ina226::alloc_guard::counted_alloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return ina226::alloc_guard::counted_alloc(size);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+#endif
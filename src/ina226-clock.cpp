@@ -0,0 +1,28 @@
+#include "ina226-clock.hpp"
+
+#if CONFIG_IDF_TARGET_LINUX
+
+#include <atomic>
+
+namespace ina226
+{
+    namespace clock
+    {
+        static std::atomic<Source> s_source{nullptr};
+        static std::atomic<void *> s_ctx{nullptr};
+
+        void set_source(Source source, void *ctx)
+        {
+            s_ctx.store(ctx, std::memory_order_relaxed);
+            s_source.store(source, std::memory_order_release);
+        }
+
+        int64_t now_us()
+        {
+            const Source source = s_source.load(std::memory_order_acquire);
+            return source ? source(s_ctx.load(std::memory_order_relaxed)) : esp_timer_get_time();
+        }
+    } // namespace clock
+} // namespace ina226
+
+#endif
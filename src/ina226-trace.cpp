@@ -0,0 +1,90 @@
+#include "ina226-trace.hpp"
+
+#if CONFIG_INA226_TRACE
+
+#include <atomic>
+#include <cinttypes>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+namespace ina226
+{
+    namespace trace
+    {
+        static constexpr uint32_t RING_SIZE = CONFIG_INA226_TRACE_RING_SIZE;
+        static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "CONFIG_INA226_TRACE_RING_SIZE doit être une puissance de 2");
+
+        static Event s_ring[RING_SIZE];
+        static std::atomic<uint32_t> s_next{0};
+
+        void record(const char *name, char phase)
+        {
+            // Réservation sans verrou : plusieurs tâches peuvent tracer en parallèle
+            const uint32_t slot = s_next.fetch_add(1, std::memory_order_relaxed) & (RING_SIZE - 1);
+            TaskHandle_t task = xTaskGetCurrentTaskHandle();
+            Event &e = s_ring[slot];
+            e.ts_us = esp_timer_get_time();
+            e.name = name;
+            e.task_name = task ? pcTaskGetName(task) : "";
+            e.task_id = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(task));
+            e.phase = phase;
+        }
+
+        size_t snapshot(Event *out, size_t max)
+        {
+            const uint32_t next = s_next.load(std::memory_order_acquire);
+            const uint32_t count = next < RING_SIZE ? next : RING_SIZE;
+            const uint32_t first = next - count;
+            size_t n = 0;
+            for (uint32_t i = 0; i < count && n < max; ++i)
+                out[n++] = s_ring[(first + i) & (RING_SIZE - 1)];
+            return n;
+        }
+
+        void clear() { s_next.store(0, std::memory_order_release); }
+
+        uint32_t overwritten()
+        {
+            const uint32_t next = s_next.load(std::memory_order_relaxed);
+            return next > RING_SIZE ? next - RING_SIZE : 0;
+        }
+
+        size_t export_chrome_json(FILE *stream, const Event *events, size_t count)
+        {
+            // Tâches distinctes (métadonnées thread_name), bornées pour rester sans allocation
+            static constexpr size_t MAX_TASKS = 16;
+            uint32_t ids[MAX_TASKS];
+            const char *names[MAX_TASKS];
+            size_t tasks = 0;
+
+            fprintf(stream, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Event &e = events[i];
+                fprintf(stream, "%s{\"name\":\"%s\",\"cat\":\"ina226\",\"ph\":\"%c\",\"ts\":%" PRId64
+                                ",\"pid\":1,\"tid\":%" PRIu32 "%s}",
+                        i ? ",\n" : "\n", e.name, e.phase, e.ts_us, e.task_id, e.phase == 'i' ? ",\"s\":\"t\"" : "");
+
+                size_t t = 0;
+                while (t < tasks && ids[t] != e.task_id)
+                    ++t;
+                if (t == tasks && tasks < MAX_TASKS)
+                {
+                    ids[tasks] = e.task_id;
+                    names[tasks] = e.task_name;
+                    ++tasks;
+                }
+            }
+            for (size_t t = 0; t < tasks; ++t)
+                fprintf(stream, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%" PRIu32
+                                ",\"args\":{\"name\":\"%s\"}}",
+                        count || t ? ",\n" : "\n", ids[t], names[t]);
+            fprintf(stream, "\n]}\n");
+            return count;
+        }
+    } // namespace trace
+} // namespace ina226
+
+#endif // CONFIG_INA226_TRACE
@@ -2,18 +2,15 @@
 #include "ina226.hpp"
 #include "sdkconfig.h"
 
-#define RETURN_IF_ERROR(x)                          \
-    do {                                             \
-        esp_err_t __err_rc = (x);                   \
-        if (__err_rc != ESP_OK) {                   \
-            ESP_LOGE("RETURN_IF_ERROR",             \
-                     "%s failed at %s:%d → %s",     \
-                     #x, __FILE__, __LINE__,        \
-                     esp_err_to_name(__err_rc));    \
-            return __err_rc;                        \
-        }                                            \
-    } while (0)
+#include <cinttypes>
+#include <type_traits>
+
+#include "esp_timer.h"
 
+#include "ina226-alloc_guard.hpp"
+#include "ina226-clock.hpp"
+#include "ina226-error.hpp"
+#include "ina226-trace.hpp"
 
 #define HANDLE_OUTPUT(format, obj)                            \
     do {                                                      \
@@ -23,8 +20,12 @@
                 obj.log();                                    \
                 break;                                        \
             case OutputFormat::JSON:                          \
-                printf("%s\n", obj.to_json().c_str());        \
+            {                                                 \
+                char json_buf[std::remove_reference_t<decltype(obj)>::JSON_SIZE]; \
+                obj.to_json(json_buf, sizeof(json_buf));      \
+                printf("%s\n", json_buf);                     \
                 break;                                        \
+            }                                                 \
             case OutputFormat::None:                          \
             default:                                          \
                 break;                                        \
@@ -44,19 +45,171 @@ namespace ina226
         return ESP_OK;
     }
 
+    ThreadingConfig ThreadingConfig::from_kconfig()
+    {
+        ThreadingConfig t;
+#if CONFIG_INA226_TASK_LAYOUT_SINGLE
+        t.split = false;
+#endif
+#ifdef CONFIG_INA226_ACQ_TASK_STACK
+        t.acquisition.stack_size = CONFIG_INA226_ACQ_TASK_STACK;
+        t.acquisition.priority = CONFIG_INA226_ACQ_TASK_PRIORITY;
+#endif
+#ifdef CONFIG_INA226_PROC_TASK_STACK
+        t.processing.stack_size = CONFIG_INA226_PROC_TASK_STACK;
+        t.processing.priority = CONFIG_INA226_PROC_TASK_PRIORITY;
+#endif
+#ifdef CONFIG_INA226_SAMPLE_QUEUE_LENGTH
+        t.queue_length = CONFIG_INA226_SAMPLE_QUEUE_LENGTH;
+#endif
+        // Mono-cœur : tout reste sur le cœur 0
+#if !CONFIG_FREERTOS_UNICORE && defined(CONFIG_INA226_ACQ_TASK_CORE)
+        t.acquisition.core = CONFIG_INA226_ACQ_TASK_CORE;
+#endif
+#if !CONFIG_FREERTOS_UNICORE && defined(CONFIG_INA226_PROC_TASK_CORE)
+        t.processing.core = CONFIG_INA226_PROC_TASK_CORE;
+#endif
+        return t;
+    }
+
+    void PipelineStats::log() const
+    {
+        static const char *TAG = "INA226_MANAGER";
+        ESP_LOGI(TAG, "Acquisition latency : mean %" PRId64 " µs, jitter %" PRId64 " µs, min %" PRId64
+                      ", max %" PRId64 " (n=%u)",
+                 acquisition_latency.mean_us(), acquisition_latency.jitter_us(),
+                 acquisition_latency.count ? acquisition_latency.min_us : 0, acquisition_latency.max_us,
+                 static_cast<unsigned>(acquisition_latency.count));
+        ESP_LOGI(TAG, "Processing latency  : mean %" PRId64 " µs, jitter %" PRId64 " µs, min %" PRId64
+                      ", max %" PRId64 " (n=%u)",
+                 processing_latency.mean_us(), processing_latency.jitter_us(),
+                 processing_latency.count ? processing_latency.min_us : 0, processing_latency.max_us,
+                 static_cast<unsigned>(processing_latency.count));
+        ESP_LOGI(TAG, "Sample interval     : mean %" PRId64 " µs, jitter %" PRId64 " µs, min %" PRId64
+                      ", max %" PRId64 " (n=%u)",
+                 sample_interval.mean_us(), sample_interval.jitter_us(),
+                 sample_interval.count ? sample_interval.min_us : 0, sample_interval.max_us,
+                 static_cast<unsigned>(sample_interval.count));
+        ESP_LOGI(TAG, "Queue overflows     : %u", static_cast<unsigned>(queue_overflows));
+        ESP_LOGI(TAG, "Coherence           : %u checks, %u retries, %u incoherent",
+                 static_cast<unsigned>(coherence_checks), static_cast<unsigned>(coherence_retries),
+                 static_cast<unsigned>(incoherent_samples));
+    }
+
     INA226Manager::INA226Manager(I2CDevices &i2c)
         : i2c_(i2c),
           cfg_(i2c_),
+#if !CONFIG_IDF_TARGET_LINUX
           alert_gpio_(gpio_num_t(CONFIG_INA226_INT_ALERT_GPIO)),
+#endif
           status_(i2c_),
           ctrl_(i2c_)
-          {}
+    {
+        rate_stats_.store(rate_.stats());
+        stats_published_.store(stats_);
+        processing_published_.store(processing_latency_);
+    }
 
     // === API PUBLIQUE ===
 
-    void INA226Manager::init()
+#if !CONFIG_INA226_HEAP_FREE
+    esp_err_t INA226Manager::init(const ThreadingConfig &threading)
+    {
+        threading_ = threading;
+        if (threading_.split)
+        {
+            sample_queue_ = xQueueCreate(threading_.queue_length, sizeof(AcquiredSample));
+            if (!sample_queue_)
+                return ESP_ERR_NO_MEM;
+            if (xTaskCreatePinnedToCore(processing_wrapper, "INA226_Proc", threading_.processing.stack_size, this,
+                                        threading_.processing.priority, &processing_handle_,
+                                        threading_.processing.core) != pdPASS)
+            {
+                release_tasks();
+                return ESP_ERR_NO_MEM;
+            }
+        }
+        if (xTaskCreatePinnedToCore(task_wrapper, "INA226_Acq", threading_.acquisition.stack_size, this,
+                                    threading_.acquisition.priority, &task_handle_,
+                                    threading_.acquisition.core) != pdPASS)
+        {
+            release_tasks();
+            return ESP_ERR_NO_MEM;
+        }
+        return ESP_OK;
+    }
+
+#endif
+
+    esp_err_t INA226Manager::init(const ThreadingConfig &threading, const StaticResources &res)
+    {
+        if (!res.acquisition_stack || !res.acquisition_tcb)
+            return ESP_ERR_INVALID_ARG;
+        if (threading.split && (!res.processing_stack || !res.processing_tcb || !res.queue_storage || !res.queue))
+            return ESP_ERR_INVALID_ARG;
+
+        threading_ = threading;
+        if (threading_.split)
+        {
+            sample_queue_ = xQueueCreateStatic(threading_.queue_length, sizeof(AcquiredSample),
+                                               res.queue_storage, res.queue);
+            processing_handle_ = xTaskCreateStaticPinnedToCore(processing_wrapper, "INA226_Proc",
+                                                               threading_.processing.stack_size, this,
+                                                               threading_.processing.priority, res.processing_stack,
+                                                               res.processing_tcb, threading_.processing.core);
+            if (!sample_queue_ || !processing_handle_)
+            {
+                release_tasks();
+                return ESP_FAIL;
+            }
+        }
+        task_handle_ = xTaskCreateStaticPinnedToCore(task_wrapper, "INA226_Acq", threading_.acquisition.stack_size,
+                                                     this, threading_.acquisition.priority, res.acquisition_stack,
+                                                     res.acquisition_tcb, threading_.acquisition.core);
+        if (!task_handle_)
+        {
+            release_tasks();
+            return ESP_FAIL;
+        }
+        return ESP_OK;
+    }
+
+    /// Échec partiel d'init() : supprime la tâche de traitement et la file déjà créées
+    void INA226Manager::release_tasks()
+    {
+        if (processing_handle_)
+            vTaskDelete(processing_handle_);
+        if (sample_queue_)
+            vQueueDelete(sample_queue_);
+        processing_handle_ = nullptr;
+        sample_queue_ = nullptr;
+        task_handle_ = nullptr;
+    }
+
+    bool INA226Manager::pipeline_stats(PipelineStats &out) const
     {
-        xTaskCreatePinnedToCore(task_wrapper, "STUSB_Task", 4096, this, 5, &task_handle_, 0);
+        TimingStats processing;
+        if (!stats_published_.load(out) || !processing_published_.load(processing))
+            return false;
+        out.processing_latency = processing;
+        return true;
+    }
+
+    void INA226Manager::attach_health(HealthMonitor *monitor)
+    {
+        health_ = monitor;
+    }
+
+    void INA226Manager::attach_transient(TransientCapture *capture, bool fast_post_trigger)
+    {
+        transient_ = capture;
+        transient_fast_ = fast_post_trigger;
+    }
+
+    void INA226Manager::set_sample_callback(SampleCallback cb, void *ctx)
+    {
+        sample_cb_ = cb;
+        sample_ctx_ = ctx;
     }
 
     esp_err_t INA226Manager::init_device()
@@ -106,7 +259,12 @@ namespace ina226
         cfg.datas().calibration.set_raw(from_kconfig.calibration.get_value());
         cfg.datas().alert_mask.set_values(from_kconfig.alert_mask.get_values());
         cfg.datas().alert_limit.set_raw(from_kconfig.alert_limit.get_value());
-        return cfg.set();
+        RETURN_IF_ERROR(cfg.set());
+        // Même échelle pour les lectures directes (CTRL::get) et la chaîne de traitement
+        scale_ = ConversionScale::from_calibration(cfg.datas().calibration.get_raw(),
+                                                   CONFIG_INA226_SHUNT_RESISTANCE_MILLIOHM);
+        ctrl_.set_scale(scale_);
+        return ESP_OK;
     }
 
     /// Envoie un soft reset au INA226
@@ -118,12 +276,15 @@ namespace ina226
 
     esp_err_t INA226Manager::handle_alert()
     {
+        INA226_TRACE_SCOPE("INA226Manager::handle_alert");
         RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
         ESP_LOGW(TAG, "ALERT triggered!");
+        // La lecture de MASK_ENABLE (0x06) acquitte CVRF / le latch et relâche la broche ALERT
+        RETURN_IF_ERROR(status_.get());
         RETURN_IF_ERROR(ctrl_.get());
         ctrl_.log();    
-        // Optionnel : tu peux ici faire un traitement plus ciblé si tu sais quelle alerte est active
-        // Ex : si MASK_ENABLE (0x06) a le bit "Shunt Over-Voltage", alors tu vérifies ça ici
+        // Optionnel : tu peux ici faire un traitement plus ciblé selon status_.status
+        // Ex : si le bit "Shunt Over-Voltage" est levé, alors tu vérifies ça ici
     
         return ESP_OK;
     }
@@ -136,10 +297,38 @@ namespace ina226
         return ESP_OK;
     }
 
-    esp_err_t INA226Manager::get_measurements(OutputFormat format)
+    void INA226Manager::set_bus_arbiter(BusArbiter *arbiter)
+    {
+        cfg_.set_arbiter(arbiter);
+        status_.set_arbiter(arbiter);
+        ctrl_.set_arbiter(arbiter);
+    }
+
+    esp_err_t INA226Manager::get_measurements(OutputFormat format, ReportFilter *filter)
     {
         RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
+        if (task_handle_)
+        {
+            // La tâche d'acquisition possède le bus : lecture de la dernière publication
+            LatestSample s;
+            if (!latest(s))
+                return ESP_ERR_NOT_FOUND;
+            if (!filter || format == OutputFormat::None || filter->accept(s.measurement))
+                print_measurement(format, s.measurement);
+            return ESP_OK;
+        }
         RETURN_IF_ERROR(ctrl_.get());
+        if (filter && format != OutputFormat::None)
+        {
+            Measurement m;
+            m.timestamp_us = clock::now_us();
+            m.shunt_uv = static_cast<float>(ctrl_.shunt_voltage_uv);
+            m.bus_mv = static_cast<float>(ctrl_.bus_voltage_mv);
+            m.current_ma = static_cast<float>(ctrl_.current_ma);
+            m.power_mw = static_cast<float>(ctrl_.power_mw);
+            if (!filter->accept(m))
+                return ESP_OK;
+        }
         HANDLE_OUTPUT(format, ctrl_);
         return ESP_OK;
     }
@@ -149,9 +338,29 @@ namespace ina226
         static_cast<INA226Manager *>(arg)->task_main();
     }
 
+    void INA226Manager::processing_wrapper(void *arg)
+    {
+        static_cast<INA226Manager *>(arg)->processing_main();
+    }
+
+    void INA226Manager::notify_alert()
+    {
+        const int64_t now = clock::now_us();
+        portENTER_CRITICAL(&edge_lock_);
+        edge_us_ = now;
+        portEXIT_CRITICAL(&edge_lock_);
+        if (task_handle_)
+            xTaskNotifyGive(task_handle_);
+    }
+
+#if !CONFIG_IDF_TARGET_LINUX
     void IRAM_ATTR INA226Manager::gpio_isr_handler(void *arg)
     {
         auto *self = static_cast<INA226Manager *>(arg);
+        const int64_t now = esp_timer_get_time();
+        portENTER_CRITICAL_ISR(&self->edge_lock_);
+        self->edge_us_ = now;
+        portEXIT_CRITICAL_ISR(&self->edge_lock_);
         BaseType_t xHigherPriorityTaskWoken = pdFALSE;
         vTaskNotifyGiveFromISR(self->task_handle_, &xHigherPriorityTaskWoken);
         portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
@@ -182,18 +391,261 @@ namespace ina226
 
         gpio_isr_handler_add(gpio, gpio_isr_handler, this);
     }
+#endif
+
+    bool INA226Manager::alert_pin_active() const
+    {
+#if CONFIG_IDF_TARGET_LINUX
+        return false; // pas de GPIO : les fronts arrivent par notify_alert()
+#else
+        return gpio_get_level(alert_gpio_) == 0;
+#endif
+    }
+
+    /// Lit et efface la date du dernier front d'un bloc : un int64_t n'est pas atomique sur la cible
+    int64_t INA226Manager::take_edge()
+    {
+        portENTER_CRITICAL(&edge_lock_);
+        const int64_t edge = edge_us_;
+        edge_us_ = 0;
+        portEXIT_CRITICAL(&edge_lock_);
+        return edge;
+    }
+
+    esp_err_t INA226Manager::acquire(AcquiredSample &out)
+    {
+        INA226_TRACE_SCOPE("INA226Manager::acquire");
+        RETURN_IF_ERROR(return_if_not_ready(ready_, TAG));
+        const int64_t edge = take_edge();
+
+        // La lecture de MASK_ENABLE (0x06) acquitte CVRF / le latch et relâche la broche ALERT.
+        // Un front daté ouvre la fenêtre de cohérence seulement si la cadence est celle des conversions
+        const uint32_t period = rate_.stats().expected_period_us;
+        const int64_t read_us = clock::now_us();
+        const int64_t read_start = esp_timer_get_time();
+        CoherentSample cs;
+        RETURN_IF_ERROR(ctrl_.get_coherent(cs, period ? edge : 0, CoherentWindow::for_period(period)));
+        status_.status.decode(cs.mask_enable);
+        out.raw = cs.raw;
+        out.mask_enable = cs.mask_enable;
+        out.coherent = cs.coherent;
+        rate_.on_sample(read_us, out.mask_enable, esp_timer_get_time() - read_start, cs.retries);
+        rate_stats_.store(rate_.stats());
+
+        stats_.coherence_checks += cs.verified;
+        stats_.coherence_retries += cs.retries;
+        if (!cs.coherent)
+            ++stats_.incoherent_samples;
+        // Broche encore active sans nouveau front : on date à partir de la lecture
+        out.edge_us = edge ? edge : out.raw.timestamp_us;
+
+        stats_.acquisition_latency.add(clock::now_us() - out.edge_us);
+        if (last_sample_us_)
+            stats_.sample_interval.add(out.raw.timestamp_us - last_sample_us_);
+        last_sample_us_ = out.raw.timestamp_us;
+        return ESP_OK;
+    }
+
+    void INA226Manager::process(const AcquiredSample &sample)
+    {
+        INA226_TRACE_SCOPE("INA226Manager::process");
+        const Measurement m = convert_sample(sample.raw, scale_);
+        latest_.store({m, sample.mask_enable, sample.coherent, ++published_});
+
+        if (reg::MaskEnable::AFF::test(sample.mask_enable))
+            ESP_LOGW(TAG, "ALERT: shunt %.1f µV, bus %.1f mV, current %.2f mA, power %.1f mW",
+                     m.shunt_uv, m.bus_mv, m.current_ma, m.power_mw);
+
+        if (transient_)
+        {
+            transient_->push(m);
+            const bool hw = reg::MaskEnable::AFF::test(sample.mask_enable);
+            const bool sw = sw_trigger_.exchange(false, std::memory_order_relaxed);
+            if ((hw || sw) && transient_->trigger(hw ? TriggerSource::Hardware : TriggerSource::Software,
+                                                  sample.mask_enable))
+            {
+                if (transient_fast_)
+                {
+                    rate_request_.store(RateRequest::Fast, std::memory_order_release);
+                    fast_requested_ = true;
+                }
+            }
+            else if (fast_requested_ && transient_->state() == TransientCapture::State::Complete)
+            {
+                rate_request_.store(RateRequest::Restore, std::memory_order_release);
+                fast_requested_ = false;
+            }
+        }
+
+        if (sample_cb_)
+            sample_cb_(m, sample_ctx_);
+
+        const bool report = !report_ || report_->accept(m);
+
+        if (sink_ && report)
+            sink_->push(m);
+
+        if (profile_)
+            profile_->add(m);
+
+        if (history_)
+            history_->add(m);
+
+        if (persist_)
+        {
+            persist_->add(m);
+            persist_->poll(m.timestamp_us);
+        }
+
+        if (report)
+            print_measurement(output_format_, m);
+
+        processing_latency_.add(clock::now_us() - sample.edge_us);
+        processing_published_.store(processing_latency_);
+    }
+
+    void INA226Manager::print_measurement(OutputFormat format, const Measurement &m) const
+    {
+        switch (format)
+        {
+        case OutputFormat::Log:
+            ESP_LOGI(TAG, "%" PRId64 " µs : %.1f µV, %.1f mV, %.2f mA, %.1f mW",
+                     m.timestamp_us, m.shunt_uv, m.bus_mv, m.current_ma, m.power_mw);
+            break;
+        case OutputFormat::JSON:
+            printf("{\"t_us\": %" PRId64
+                   ",\"shunt_uv\": %.1f,\"bus_mv\": %.1f,\"current_ma\": %.2f,\"power_mw\": %.1f}\n",
+                   m.timestamp_us, m.shunt_uv, m.bus_mv, m.current_ma, m.power_mw);
+            break;
+        case OutputFormat::None:
+        default:
+            break;
+        }
+    }
+
+    void INA226Manager::apply_rate_request()
+    {
+        if (rate_reset_.exchange(false, std::memory_order_acquire))
+        {
+            rate_.reset();
+            rate_stats_.store(rate_.stats());
+        }
+
+        const RateRequest req = rate_request_.exchange(RateRequest::None, std::memory_order_acquire);
+        if (req == RateRequest::None)
+            return;
+
+        ConfigurationRegister &reg = cfg_.datas().configuration;
+        if (req == RateRequest::Fast && !fast_active_)
+        {
+            // Cadence maximale : 140 µs par voie, sans moyenne, mode inchangé
+            saved_config_ = reg.get_raw();
+            ConfigurationRegister::ConfigurationReg values = reg.get_values();
+            values.averaging = ConfigurationRegister::AveragingMode::AVG_1;
+            values.bus_conv_time = ConfigurationRegister::ConversionTime::CT_140us;
+            values.shunt_conv_time = ConfigurationRegister::ConversionTime::CT_140us;
+            reg.set_values(values);
+            if (cfg_.set_config() == ESP_OK)
+                fast_active_ = true;
+            else
+                reg.set_raw(saved_config_);
+        }
+        else if (req == RateRequest::Restore && fast_active_)
+        {
+            reg.set_raw(saved_config_);
+            if (cfg_.set_config() == ESP_OK)
+                fast_active_ = false;
+        }
+        rate_.configure(cfg_.datas());
+        rate_stats_.store(rate_.stats());
+    }
+
+    TickType_t INA226Manager::sink_poll_ticks() const
+    {
+        if (!sink_ || sink_->policy().max_age_ms == 0)
+            return portMAX_DELAY;
+        const TickType_t ticks = pdMS_TO_TICKS(sink_->policy().max_age_ms);
+        return ticks ? ticks : 1;
+    }
+
+    TickType_t INA226Manager::acquisition_wait_ticks() const
+    {
+        TickType_t wait = threading_.split ? portMAX_DELAY : sink_poll_ticks();
+        if (health_ && health_->edge_timeout_ms())
+        {
+            const TickType_t ticks = pdMS_TO_TICKS(health_->edge_timeout_ms());
+            const TickType_t health_wait = ticks ? ticks : 1;
+            if (health_wait < wait)
+                wait = health_wait;
+        }
+        return wait;
+    }
+
+    void INA226Manager::processing_main()
+    {
+        AcquiredSample sample;
+        const TickType_t wait = sink_poll_ticks();
+        while (true)
+        {
+            if (xQueueReceive(sample_queue_, &sample, wait) == pdTRUE)
+                process(sample);
+            if (sink_)
+                sink_->poll();
+        }
+    }
 
     void INA226Manager::task_main()
     {
+#if !CONFIG_IDF_TARGET_LINUX
         setup_interrupt(alert_gpio_);
+#endif
         init_device();
+#if CONFIG_INA226_ALLOC_GUARD
+        // Initialisation terminée : plus aucune allocation n'est tolérée
+        alloc_guard::arm();
+#endif
 
+        rate_.configure(cfg_.datas());
+        rate_stats_.store(rate_.stats());
+        if (health_)
+            health_->start(clock::now_us());
+
+        // Tâche d'acquisition : uniquement l'I2C, le reste part dans la file
         while (true)
         {
-            if (gpio_get_level(alert_gpio_) == 0 || ulTaskNotifyTake(pdTRUE, portMAX_DELAY))
+            // En mode une seule tâche, c'est elle qui vide les lots de télémétrie trop anciens
+            if (!threading_.split && sink_)
+                sink_->poll();
+
+            if (alert_pin_active() || ulTaskNotifyTake(pdTRUE, acquisition_wait_ticks()))
+            {
+                INA226_TRACE_SCOPE("INA226Manager::task_main");
+                apply_rate_request();
+
+                AcquiredSample sample;
+                esp_err_t err = acquire(sample);
+                if (health_)
+                {
+                    if (err == ESP_OK)
+                        health_->on_sample(sample.raw, sample.mask_enable);
+                    else
+                        health_->on_bus_error(err);
+                }
+
+                if (err == ESP_OK)
+                {
+                    if (!threading_.split)
+                        process(sample);
+                    else if (xQueueSend(sample_queue_, &sample, 0) != pdTRUE)
+                        ++stats_.queue_overflows;
+                    stats_published_.store(stats_);
+                }
+            }
+
+            if (health_ && health_->check(clock::now_us()) != HealthFault::None)
             {
-                ESP_LOGE(TAG, "Alert");
-                handle_alert();
+                INA226_TRACE_SCOPE("HealthMonitor::recover");
+                health_->recover();
             }
         }
     }
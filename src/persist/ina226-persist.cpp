@@ -0,0 +1,432 @@
+#include "persist/ina226-persist.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include <unistd.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "ina226-clock.hpp"
+#include "ina226-crc.hpp"
+#include "ina226-format.hpp"
+
+namespace ina226
+{
+    static const char *TAG = "INA226-PERSIST";
+
+    static constexpr uint32_t CHECKPOINT_MAGIC = 0x504B4349; // "ICKP"
+
+    static void put_u32(uint8_t *p, uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i)
+            p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+
+    static uint32_t get_u32(const uint8_t *p)
+    {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    // === NvsStorage ===
+
+#if !CONFIG_IDF_TARGET_LINUX
+    NvsStorage::~NvsStorage()
+    {
+        close();
+    }
+
+    esp_err_t NvsStorage::open(const char *name_space, const char *partition)
+    {
+        close();
+        snprintf(partition_, sizeof(partition_), "%s", partition);
+        esp_err_t err = nvs_open_from_partition(partition_, name_space, NVS_READWRITE, &handle_);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Ouverture NVS '%s' impossible : %s", name_space, esp_err_to_name(err));
+            return err;
+        }
+        open_ = true;
+        return ESP_OK;
+    }
+
+    void NvsStorage::close()
+    {
+        if (open_)
+            nvs_close(handle_);
+        open_ = false;
+    }
+
+    esp_err_t NvsStorage::load(const char *key, void *buf, size_t capacity, size_t &len)
+    {
+        if (!open_)
+            return ESP_ERR_INVALID_STATE;
+        size_t size = 0;
+        esp_err_t err = nvs_get_blob(handle_, key, nullptr, &size);
+        if (err == ESP_ERR_NVS_NOT_FOUND)
+            return ESP_ERR_NOT_FOUND;
+        if (err != ESP_OK)
+            return err;
+        if (size > capacity)
+            return ESP_ERR_INVALID_SIZE;
+        err = nvs_get_blob(handle_, key, buf, &size);
+        len = size;
+        return err;
+    }
+
+    esp_err_t NvsStorage::store(const char *key, const void *data, size_t len)
+    {
+        if (!open_)
+            return ESP_ERR_INVALID_STATE;
+        esp_err_t err = nvs_set_blob(handle_, key, data, len);
+        return err == ESP_OK ? nvs_commit(handle_) : err;
+    }
+
+    esp_err_t NvsStorage::check_capacity(size_t len, size_t copies) const
+    {
+        nvs_stats_t stats;
+        if (nvs_get_stats(partition_, &stats) != ESP_OK)
+            return ESP_OK; // taille inconnue : l'écriture dira
+        // Une page reste réservée au ramasse-miettes
+        const size_t usable = stats.total_entries > ENTRIES_PER_PAGE
+                                  ? (stats.total_entries - ENTRIES_PER_PAGE) * ENTRY_SIZE
+                                  : 0;
+        const size_t needed = footprint(len) * copies;
+        if (needed <= usable)
+            return ESP_OK;
+        ESP_LOGE(TAG, "Partition NVS '%s' trop petite : %u octets nécessaires, %u utilisables", partition_,
+                 static_cast<unsigned>(needed), static_cast<unsigned>(usable));
+        return ESP_ERR_NO_MEM;
+    }
+#endif
+
+    // === FileStorage ===
+
+    esp_err_t FileStorage::open(const char *directory)
+    {
+        const int n = snprintf(dir_, sizeof(dir_), "%s", directory);
+        if (n <= 0 || static_cast<size_t>(n) >= sizeof(dir_))
+        {
+            dir_[0] = '\0';
+            return ESP_ERR_INVALID_ARG;
+        }
+        return ESP_OK;
+    }
+
+    bool FileStorage::path_of(const char *key, char *out, size_t len) const
+    {
+        if (!dir_[0])
+            return false;
+        const int n = snprintf(out, len, "%s/%s", dir_, key);
+        return n > 0 && static_cast<size_t>(n) < len;
+    }
+
+    esp_err_t FileStorage::load(const char *key, void *buf, size_t capacity, size_t &len)
+    {
+        char path[96];
+        if (!path_of(key, path, sizeof(path)))
+            return ESP_ERR_INVALID_STATE;
+        FILE *f = fopen(path, "rb");
+        if (!f)
+            return ESP_ERR_NOT_FOUND;
+        len = fread(buf, 1, capacity, f);
+        // Un octet de plus : le fichier dépasse le tampon
+        uint8_t extra;
+        const bool too_long = len == capacity && fread(&extra, 1, 1, f) == 1;
+        fclose(f);
+        return too_long ? ESP_ERR_INVALID_SIZE : ESP_OK;
+    }
+
+    esp_err_t FileStorage::store(const char *key, const void *data, size_t len)
+    {
+        char path[96];
+        if (!path_of(key, path, sizeof(path)))
+            return ESP_ERR_INVALID_STATE;
+        FILE *f = fopen(path, "wb");
+        if (!f)
+        {
+            ESP_LOGE(TAG, "Ouverture de %s impossible", path);
+            return ESP_FAIL;
+        }
+        bool ok = fwrite(data, 1, len, f) == len && fflush(f) == 0;
+        ok = fsync(fileno(f)) == 0 && ok;
+        return fclose(f) == 0 && ok ? ESP_OK : ESP_FAIL;
+    }
+
+    // === Checkpoint ===
+
+    // En-tête : magic, version (u16), réservé (u16), séquence, longueur, CRC-32 de l'en-tête
+    // (CRC exclu) puis de la charge utile
+    Checkpoint::Checkpoint(Storage &storage, const char *name, uint8_t *scratch, size_t capacity, uint16_t version)
+        : storage_(storage),
+          buf_(scratch),
+          capacity_(capacity),
+          version_(version)
+    {
+        snprintf(keys_[0], sizeof(keys_[0]), "%.12s.a", name);
+        snprintf(keys_[1], sizeof(keys_[1]), "%.12s.b", name);
+    }
+
+    esp_err_t Checkpoint::commit(size_t len)
+    {
+        if (len > payload_capacity())
+            return ESP_ERR_INVALID_SIZE;
+        const uint32_t seq = sequence_ + 1;
+        put_u32(buf_, CHECKPOINT_MAGIC);
+        buf_[4] = static_cast<uint8_t>(version_);
+        buf_[5] = static_cast<uint8_t>(version_ >> 8);
+        buf_[6] = buf_[7] = 0;
+        put_u32(buf_ + 8, seq);
+        put_u32(buf_ + 12, static_cast<uint32_t>(len));
+        put_u32(buf_ + 16, crc32(payload(), len, crc32(buf_, 16)));
+
+        const int64_t start = esp_timer_get_time();
+        esp_err_t err = storage_.store(keys_[next_slot_], buf_, HEADER_SIZE + len);
+        stats_.write_duration.add(esp_timer_get_time() - start);
+        if (err != ESP_OK)
+        {
+            // Emplacement peut-être partiellement écrit : on le réessaiera, l'autre reste intact
+            ++stats_.failures;
+            return err;
+        }
+        ++stats_.writes;
+        stats_.bytes += HEADER_SIZE + len;
+        sequence_ = seq;
+        next_slot_ ^= 1;
+        return ESP_OK;
+    }
+
+    bool Checkpoint::read_slot(int slot, size_t &len, uint32_t &seq)
+    {
+        size_t n = 0;
+        esp_err_t err = storage_.load(keys_[slot], buf_, capacity_, n);
+        if (err == ESP_ERR_NOT_FOUND)
+            return false;
+        const bool valid = err == ESP_OK && n >= HEADER_SIZE && get_u32(buf_) == CHECKPOINT_MAGIC &&
+                           (buf_[4] | (buf_[5] << 8)) == version_ && get_u32(buf_ + 12) == n - HEADER_SIZE &&
+                           get_u32(buf_ + 16) == crc32(payload(), n - HEADER_SIZE, crc32(buf_, 16));
+        if (!valid)
+        {
+            ++stats_.corrupt;
+            return false;
+        }
+        len = n - HEADER_SIZE;
+        seq = get_u32(buf_ + 8);
+        return true;
+    }
+
+    esp_err_t Checkpoint::restore(size_t &len)
+    {
+        size_t len_a = 0, len_b = 0;
+        uint32_t seq_a = 0, seq_b = 0;
+        const bool a = read_slot(0, len_a, seq_a);
+        const bool b = read_slot(1, len_b, seq_b);
+        if (!a && !b)
+            return ESP_ERR_NOT_FOUND;
+
+        // Comparaison modulo 2^32 ; le tampon contient la dernière lecture (b), à refaire pour a
+        const bool take_b = b && (!a || static_cast<int32_t>(seq_b - seq_a) > 0);
+        if (!take_b)
+            read_slot(0, len_a, seq_a);
+        len = take_b ? len_b : len_a;
+        sequence_ = take_b ? seq_b : seq_a;
+        next_slot_ = take_b ? 0 : 1;
+        return ESP_OK;
+    }
+
+    // === StatePersistence ===
+
+    PersistPolicy PersistPolicy::from_kconfig()
+    {
+        PersistPolicy p;
+        p.totals_interval_s = CONFIG_INA226_CHECKPOINT_INTERVAL_S;
+        p.history_interval_s = CONFIG_INA226_HISTORY_CHECKPOINT_INTERVAL_S;
+        return p;
+    }
+
+    float PersistStats::writes_per_day(int64_t elapsed_us) const
+    {
+        return elapsed_us > 0 ? (totals_writes + history_writes) * 86400e6f / elapsed_us : 0.0f;
+    }
+
+    void PersistStats::log() const
+    {
+        ESP_LOGI(TAG, "Écritures : compteurs %" PRIu32 ", historique %" PRIu32 ", échecs %" PRIu32
+                      ", emplacements corrompus %" PRIu32 ", %llu octets",
+                 totals_writes, history_writes, failures, corrupt, static_cast<unsigned long long>(bytes));
+        ESP_LOGI(TAG, "Durée d'écriture : mean %" PRId64 " µs, max %" PRId64 " µs ; perte max sur coupure %.3f J",
+                 write_duration.mean_us(), write_duration.max_us, max_unsaved_energy_mj / 1000.0);
+    }
+
+    size_t PersistStats::to_json(char *buf, size_t len) const
+    {
+        return format_to(buf, len,
+                         "{\"totals_writes\": %" PRIu32 ",\"history_writes\": %" PRIu32 ",\"failures\": %" PRIu32
+                         ",\"corrupt\": %" PRIu32 ",\"bytes\": %llu,\"write_mean_us\": %" PRId64
+                         ",\"write_max_us\": %" PRId64 ",\"max_unsaved_energy_mj\": %.3f}",
+                         totals_writes, history_writes, failures, corrupt, static_cast<unsigned long long>(bytes),
+                         write_duration.mean_us(), write_duration.max_us, max_unsaved_energy_mj);
+    }
+
+    std::string PersistStats::to_json() const
+    {
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
+    }
+
+    StatePersistence::StatePersistence(Storage &storage, uint8_t *scratch, size_t capacity,
+                                       const PersistPolicy &policy)
+        : StatePersistence(storage, storage, scratch, capacity, policy)
+    {
+    }
+
+    StatePersistence::StatePersistence(Storage &totals_storage, Storage &history_storage, uint8_t *scratch,
+                                       size_t capacity, const PersistPolicy &policy)
+        : history_storage_(history_storage),
+          totals_cp_(totals_storage, "tot", scratch, capacity),
+          history_cp_(history_storage, "hist", scratch, capacity),
+          policy_(policy)
+    {
+    }
+
+    esp_err_t StatePersistence::restore()
+    {
+        size_t len = 0;
+        esp_err_t err = totals_cp_.restore(len);
+        if (err == ESP_OK && len == sizeof(EnergyTotals))
+        {
+            std::memcpy(&totals_, totals_cp_.payload(), sizeof(totals_));
+            ++totals_.boots;
+            saved_energy_mj_ = totals_.energy_mj;
+            ESP_LOGI(TAG, "Compteurs restaurés : %.3f J, %u démarrage(s)", totals_.energy_mj / 1000.0,
+                     static_cast<unsigned>(totals_.boots));
+        }
+        else if (err == ESP_OK)
+        {
+            err = ESP_ERR_INVALID_SIZE;
+        }
+
+        // Deux emplacements plus la nouvelle copie écrite avant l'effacement de l'ancienne
+        history_fits_ = !history_ ||
+                        history_storage_.check_capacity(Checkpoint::HEADER_SIZE + HistoryStore::SNAPSHOT_SIZE, 3) ==
+                            ESP_OK;
+        if (history_ && !history_fits_)
+            ESP_LOGE(TAG, "Historique non persistant : support trop petit pour son image");
+
+        if (history_enabled())
+        {
+            const esp_err_t herr = history_cp_.restore(len);
+            if (herr == ESP_OK)
+            {
+                const esp_err_t lerr = history_->load(history_cp_.payload(), len);
+                if (lerr != ESP_OK)
+                    ESP_LOGW(TAG, "Historique incompatible (profondeurs modifiées ?) : ignoré");
+            }
+        }
+        stats_.corrupt = totals_cp_.stats().corrupt + history_cp_.stats().corrupt;
+        return err;
+    }
+
+    void StatePersistence::add(const Measurement &m)
+    {
+        if (has_last_)
+        {
+            const int64_t dt_us = m.timestamp_us - last_us_;
+            if (dt_us > 0 && dt_us <= static_cast<int64_t>(policy_.max_gap_s) * 1000000)
+            {
+                const double dt_s = dt_us * 1e-6;
+                totals_.energy_mj += 0.5 * (static_cast<double>(m.power_mw) + last_mw_) * dt_s;
+                totals_.charge_mc += 0.5 * (static_cast<double>(m.current_ma) + last_ma_) * dt_s;
+                totals_.runtime_us += dt_us;
+            }
+        }
+        ++totals_.samples;
+        last_us_ = m.timestamp_us;
+        last_mw_ = m.power_mw;
+        last_ma_ = m.current_ma;
+        has_last_ = true;
+        dirty_ = true;
+    }
+
+    void StatePersistence::account(esp_err_t err, int64_t start_us)
+    {
+        stats_.write_duration.add(esp_timer_get_time() - start_us);
+        if (err != ESP_OK)
+        {
+            ++stats_.failures;
+            ESP_LOGW(TAG, "Sauvegarde échouée : %s", esp_err_to_name(err));
+            return;
+        }
+        stats_.bytes = totals_cp_.stats().bytes + history_cp_.stats().bytes;
+    }
+
+    esp_err_t StatePersistence::save_totals(int64_t now_us)
+    {
+        const int64_t start = esp_timer_get_time();
+        std::memcpy(totals_cp_.payload(), &totals_, sizeof(totals_));
+        const esp_err_t err = totals_cp_.commit(sizeof(totals_));
+        account(err, start);
+        totals_saved_us_ = now_us;
+        if (err == ESP_OK)
+        {
+            const double unsaved = unsaved_energy_mj();
+            if (unsaved > stats_.max_unsaved_energy_mj)
+                stats_.max_unsaved_energy_mj = unsaved;
+            saved_energy_mj_ = totals_.energy_mj;
+            ++stats_.totals_writes;
+            dirty_ = false;
+        }
+        return err;
+    }
+
+    esp_err_t StatePersistence::save_history(int64_t now_us)
+    {
+        const int64_t start = esp_timer_get_time();
+        const size_t len = history_->save(history_cp_.payload(), history_cp_.payload_capacity());
+        const esp_err_t err = len ? history_cp_.commit(len) : ESP_ERR_INVALID_SIZE;
+        account(err, start);
+        history_saved_us_ = now_us;
+        if (err == ESP_OK)
+            ++stats_.history_writes;
+        return err;
+    }
+
+    esp_err_t StatePersistence::poll(int64_t now_us)
+    {
+        // Premier appel : les intervalles partent de maintenant
+        if (!totals_saved_us_)
+            totals_saved_us_ = now_us;
+        if (!history_saved_us_)
+            history_saved_us_ = now_us;
+
+        esp_err_t err = ESP_OK;
+        if (dirty_ && policy_.totals_interval_s &&
+            now_us - totals_saved_us_ >= static_cast<int64_t>(policy_.totals_interval_s) * 1000000)
+            err = save_totals(now_us);
+        if (history_enabled() && policy_.history_interval_s &&
+            now_us - history_saved_us_ >= static_cast<int64_t>(policy_.history_interval_s) * 1000000)
+        {
+            const esp_err_t herr = save_history(now_us);
+            if (err == ESP_OK)
+                err = herr;
+        }
+        return err;
+    }
+
+    esp_err_t StatePersistence::flush()
+    {
+        const int64_t now = clock::now_us();
+        esp_err_t err = save_totals(now);
+        if (history_enabled())
+        {
+            const esp_err_t herr = save_history(now);
+            if (err == ESP_OK)
+                err = herr;
+        }
+        return err;
+    }
+
+} // namespace ina226
@@ -0,0 +1,161 @@
+#include "profile/ina226-profile.hpp"
+
+#include <cinttypes>
+#include <cstring>
+
+#include "esp_log.h"
+
+#include "ina226-format.hpp"
+
+namespace ina226
+{
+    // En-tête de encode() : début et fin de période, puis chaque sketch préfixé de sa longueur
+    static void put_u32(uint8_t *p, uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i)
+            p[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+
+    static uint32_t get_u32(const uint8_t *p)
+    {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    LoadProfile::LoadProfile(uint32_t period_s, ReportCallback cb, void *ctx)
+        : period_us_(static_cast<int64_t>(period_s) * 1000000),
+          cb_(cb),
+          ctx_(ctx)
+    {
+    }
+
+    void LoadProfile::add(const Measurement &m)
+    {
+        if (period_us_ && current_.count() && m.timestamp_us - start_us_ >= period_us_)
+            close_period(m.timestamp_us);
+        if (!current_.count())
+            start_us_ = m.timestamp_us;
+        end_us_ = m.timestamp_us;
+        current_.add(m.current_ma);
+        power_.add(m.power_mw);
+    }
+
+    void LoadProfile::close_period(int64_t now_us)
+    {
+        if (!current_.count())
+            return;
+        end_us_ = now_us;
+        if (cb_)
+            cb_(*this, ctx_);
+        reset();
+    }
+
+    void LoadProfile::merge(const LoadProfile &other)
+    {
+        if (!other.current_.count())
+            return;
+        if (!current_.count() || other.start_us_ < start_us_)
+            start_us_ = other.start_us_;
+        if (other.end_us_ > end_us_)
+            end_us_ = other.end_us_;
+        current_.merge(other.current_);
+        power_.merge(other.power_);
+    }
+
+    size_t LoadProfile::encode(uint8_t *buf, size_t len) const
+    {
+        if (len < 24)
+            return 0;
+        std::memcpy(buf, &start_us_, 8);
+        std::memcpy(buf + 8, &end_us_, 8);
+        size_t n = 16;
+
+        const size_t c = current_.encode(buf + n + 4, len - n - 4);
+        if (!c)
+            return 0;
+        put_u32(buf + n, static_cast<uint32_t>(c));
+        n += 4 + c;
+
+        if (len - n < 4)
+            return 0;
+        const size_t p = power_.encode(buf + n + 4, len - n - 4);
+        if (!p)
+            return 0;
+        put_u32(buf + n, static_cast<uint32_t>(p));
+        return n + 4 + p;
+    }
+
+    esp_err_t LoadProfile::merge_encoded(const uint8_t *buf, size_t len)
+    {
+        if (len < 24)
+            return ESP_ERR_INVALID_SIZE;
+        int64_t start, end;
+        std::memcpy(&start, buf, 8);
+        std::memcpy(&end, buf + 8, 8);
+
+        const size_t c = get_u32(buf + 16);
+        if (c > len - 20 || len - 20 - c < 4)
+            return ESP_ERR_INVALID_SIZE;
+        const uint8_t *cur = buf + 20;
+        const size_t p = get_u32(cur + c);
+        if (p > len - 24 - c)
+            return ESP_ERR_INVALID_SIZE;
+        const uint8_t *pow = cur + c + 4;
+
+        // Validation complète (format et débordements) avant toute modification
+        esp_err_t err = current_.check_encoded(cur, c);
+        if (err == ESP_OK)
+            err = power_.check_encoded(pow, p);
+        if (err != ESP_OK)
+            return err;
+
+        const bool empty = !current_.count();
+        current_.merge_encoded(cur, c);
+        power_.merge_encoded(pow, p);
+        if (empty || start < start_us_)
+            start_us_ = start;
+        if (end > end_us_)
+            end_us_ = end;
+        return ESP_OK;
+    }
+
+    void LoadProfile::reset()
+    {
+        current_.reset();
+        power_.reset();
+        start_us_ = end_us_ = 0;
+    }
+
+    void LoadProfile::log() const
+    {
+        ESP_LOGI(TAG, "Période %" PRId64 " → %" PRId64 " µs, %llu échantillons", start_us_, end_us_,
+                 static_cast<unsigned long long>(current_.count()));
+        ESP_LOGI(TAG, "Courant (mA)   : min %.2f, moy %.2f, max %.2f", current_.min(), current_.mean(), current_.max());
+        for (double q : QUANTILES)
+            ESP_LOGI(TAG, "  p%-5g : %10.2f mA %10.1f mW", q * 100, current_.quantile(q), power_.quantile(q));
+        ESP_LOGI(TAG, "Puissance (mW) : min %.1f, moy %.1f, max %.1f", power_.min(), power_.mean(), power_.max());
+    }
+
+    size_t LoadProfile::to_json(char *buf, size_t len) const
+    {
+        size_t n = format_to(buf, len, "{\"start_us\": %" PRId64 ",\"end_us\": %" PRId64 ",\"count\": %llu",
+                             start_us_, end_us_, static_cast<unsigned long long>(current_.count()));
+        n += format_to(buf + n, len - n, ",\"current_ma\": {\"min\": %.3f,\"mean\": %.3f,\"max\": %.3f",
+                       current_.min(), current_.mean(), current_.max());
+        for (double q : QUANTILES)
+            n += format_to(buf + n, len - n, ",\"p%g\": %.3f", q * 100, current_.quantile(q));
+        n += format_to(buf + n, len - n, "},\"power_mw\": {\"min\": %.2f,\"mean\": %.2f,\"max\": %.2f",
+                       power_.min(), power_.mean(), power_.max());
+        for (double q : QUANTILES)
+            n += format_to(buf + n, len - n, ",\"p%g\": %.2f", q * 100, power_.quantile(q));
+        n += format_to(buf + n, len - n, "}}");
+        return n;
+    }
+
+    std::string LoadProfile::to_json() const
+    {
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
+    }
+
+} // namespace ina226
@@ -0,0 +1,134 @@
+#include "rate/ina226-rate.hpp"
+
+#include <cinttypes>
+
+#include "esp_log.h"
+
+#include "ina226-format.hpp"
+
+namespace ina226
+{
+    static const char *TAG = "INA226-RATE";
+
+    float RateStats::achieved_sps() const
+    {
+        const int64_t span = last_us - first_us;
+        if (fresh < 2 || span <= 0)
+            return 0.0f;
+        return (fresh - 1) * 1e6f / span;
+    }
+
+    float RateStats::theoretical_sps() const
+    {
+        return expected_period_us ? 1e6f / expected_period_us : 0.0f;
+    }
+
+    float RateStats::efficiency() const
+    {
+        const uint32_t produced = fresh + missed;
+        return produced ? static_cast<float>(fresh) / produced : 0.0f;
+    }
+
+    float RateStats::bus_utilization() const
+    {
+        return expected_period_us ? static_cast<float>(read_duration.mean_us()) / expected_period_us : 0.0f;
+    }
+
+    void RateStats::log() const
+    {
+        ESP_LOGI(TAG, "Période attendue : %" PRIu32 " µs (%.1f éch/s), mesuré %.1f éch/s, efficacité %.1f %%",
+                 expected_period_us, theoretical_sps(), achieved_sps(), efficiency() * 100.0f);
+        ESP_LOGI(TAG, "Conversions lues %" PRIu32 ", relues %" PRIu32 ", perdues %" PRIu32,
+                 fresh, duplicated, missed);
+        ESP_LOGI(TAG, "Intervalle frais : mean %" PRId64 " µs, jitter %" PRId64 " µs, min %" PRId64 ", max %" PRId64,
+                 fresh_interval.mean_us(), fresh_interval.jitter_us(),
+                 fresh_interval.count ? fresh_interval.min_us : 0, fresh_interval.max_us);
+        ESP_LOGI(TAG, "Durée de lecture : mean %" PRId64 " µs, max %" PRId64 " µs, occupation bus %.1f %%",
+                 read_duration.mean_us(), read_duration.max_us, bus_utilization() * 100.0f);
+    }
+
+    size_t RateStats::to_json(char *buf, size_t len) const
+    {
+        return format_to(buf, len,
+                         "{\"expected_period_us\": %" PRIu32 ",\"theoretical_sps\": %.2f,\"achieved_sps\": %.2f,"
+                         "\"fresh\": %" PRIu32 ",\"duplicated\": %" PRIu32 ",\"missed\": %" PRIu32
+                         ",\"efficiency\": %.4f,\"interval_mean_us\": %" PRId64 ",\"interval_jitter_us\": %" PRId64
+                         ",\"read_mean_us\": %" PRId64 ",\"bus_utilization\": %.4f}",
+                         expected_period_us, theoretical_sps(), achieved_sps(), fresh, duplicated, missed,
+                         efficiency(), fresh_interval.mean_us(), fresh_interval.jitter_us(),
+                         read_duration.mean_us(), bus_utilization());
+    }
+
+    std::string RateStats::to_json() const
+    {
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
+    }
+
+    uint32_t RateMonitor::expected_period_us(const ConfigParams &params)
+    {
+        // Seul le mode continu convertit à cadence fixe ; sans CNVR, les lectures ne suivent pas les conversions
+        const auto mode = static_cast<uint8_t>(params.configuration.get_values().mode);
+        if (!(mode & 0b100) || !params.alert_mask.get_values().conversion_ready) // MODE3 : continu
+            return 0;
+        return params.configuration.conversion_period_us();
+    }
+
+    void RateMonitor::configure(const ConfigParams &params)
+    {
+        stats_.expected_period_us = expected_period_us(params);
+        // Intervalle à cheval sur deux configurations : non comptabilisé
+        last_fresh_us_ = 0;
+    }
+
+    void RateMonitor::on_sample(int64_t read_us, uint16_t mask_enable, int64_t read_duration_us, uint8_t retries)
+    {
+        stats_.read_duration.add(read_duration_us);
+        if (!reg::MaskEnable::CVRF::test(mask_enable))
+        {
+            ++stats_.duplicated;
+        }
+        else
+        {
+            ++stats_.fresh;
+            if (!stats_.first_us)
+                stats_.first_us = read_us;
+            stats_.last_us = read_us;
+
+            if (last_fresh_us_)
+            {
+                const int64_t dt = read_us - last_fresh_us_;
+                stats_.fresh_interval.add(dt);
+                const uint32_t period = stats_.expected_period_us;
+                if (period)
+                {
+                    // Nombre de périodes écoulées, arrondi : tolère la gigue de réveil et la dérive de l'oscillateur
+                    const int64_t periods = (dt + period / 2) / period;
+                    if (periods > 1)
+                        stats_.missed += static_cast<uint32_t>(periods - 1);
+                }
+            }
+            last_fresh_us_ = read_us;
+        }
+
+        if (retries)
+        {
+            // Conversions terminées pendant la lecture : la dernière précède la fin de l'acquisition
+            stats_.fresh += retries;
+            stats_.last_us = read_us + read_duration_us;
+            if (!stats_.first_us)
+                stats_.first_us = stats_.last_us;
+            last_fresh_us_ = stats_.last_us;
+        }
+    }
+
+    void RateMonitor::reset()
+    {
+        const uint32_t period = stats_.expected_period_us;
+        stats_ = RateStats{};
+        stats_.expected_period_us = period;
+        last_fresh_us_ = 0;
+    }
+
+} // namespace ina226
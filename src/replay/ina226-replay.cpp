@@ -0,0 +1,321 @@
+#include "replay/ina226-replay.hpp"
+
+#include <chrono>
+#include <thread>
+
+#include "esp_log.h"
+
+#include "ina226-clock.hpp"
+
+namespace ina226
+{
+    // Bits du registre Mask/Enable (0x06)
+    using ME = reg::MaskEnable;
+    static constexpr uint16_t ME_SOL = ME::SOL::mask;
+    static constexpr uint16_t ME_SUL = ME::SUL::mask;
+    static constexpr uint16_t ME_BOL = ME::BOL::mask;
+    static constexpr uint16_t ME_BUL = ME::BUL::mask;
+    static constexpr uint16_t ME_POL = ME::POL::mask;
+    static constexpr uint16_t ME_CNVR = ME::CNVR::mask;
+    static constexpr uint16_t ME_AFF = ME::AFF::mask;
+    static constexpr uint16_t ME_CVRF = ME::CVRF::mask;
+    static constexpr uint16_t ME_LEN = ME::LEN::mask;
+    static constexpr uint16_t ME_FUNCTIONS = ME::FUNCTIONS;
+    static constexpr uint16_t ME_WRITABLE = ME::WRITABLE;
+
+    ReplayBus::~ReplayBus()
+    {
+#if CONFIG_IDF_TARGET_LINUX
+        ReplayBus *self = this;
+        if (s_clock_owner.compare_exchange_strong(self, nullptr))
+            clock::set_source(nullptr, nullptr);
+#endif
+    }
+
+    void ReplayBus::load(const RawSample *samples, size_t count, uint16_t calibration_raw)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            samples_ = samples;
+            count_ = count;
+            next_ = 0;
+#if CONFIG_IDF_TARGET_LINUX
+            reader_ = nullptr;
+#endif
+            regs_[5] = calibration_raw;
+            replayed_ = dropped_ = edges_ = 0;
+        }
+        start_clock(count ? samples[0].timestamp_us : 0);
+    }
+
+#if CONFIG_IDF_TARGET_LINUX
+    void ReplayBus::load(const CaptureReader &reader)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            samples_ = nullptr;
+            count_ = 0;
+            reader_ = &reader;
+            pos_ = {};
+            const CaptureFileHeader &h = reader.header();
+            regs_[0] = h.config_raw;
+            regs_[5] = h.calibration_raw;
+            regs_[6] = h.alert_mask_raw & ME_WRITABLE;
+            regs_[7] = h.alert_limit_raw;
+            replayed_ = dropped_ = edges_ = 0;
+        }
+        start_clock(reader.first_time_us());
+    }
+#endif
+
+    void ReplayBus::start_clock(int64_t first_us)
+    {
+        {
+            std::lock_guard<std::mutex> lock(clock_mutex_);
+            clock_base_us_ = clock_limit_us_ = first_us;
+            clock_speed_ = 0.0f;
+        }
+#if CONFIG_IDF_TARGET_LINUX
+        if (drive_clock_)
+        {
+            s_clock_owner.store(this);
+            clock::set_source(&ReplayBus::clock_thunk, this);
+        }
+#endif
+    }
+
+    int64_t ReplayBus::clock_thunk(void *ctx)
+    {
+        return static_cast<const ReplayBus *>(ctx)->virtual_time_us();
+    }
+
+    int64_t ReplayBus::virtual_time_us() const
+    {
+        std::lock_guard<std::mutex> lock(clock_mutex_);
+        if (clock_speed_ <= 0.0f)
+            return clock_base_us_;
+        const auto real = std::chrono::steady_clock::now() - clock_anchor_;
+        const int64_t t = clock_base_us_ + static_cast<int64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(real).count() * clock_speed_);
+        return t < clock_limit_us_ ? t : clock_limit_us_;
+    }
+
+    void ReplayBus::set_edge_callback(EdgeCallback cb, void *ctx)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        edge_cb_ = cb;
+        edge_ctx_ = ctx;
+    }
+
+    esp_err_t ReplayBus::read(uint8_t reg, uint8_t *data, size_t len)
+    {
+        if (len != 2)
+            return ESP_ERR_INVALID_SIZE;
+
+        uint16_t value = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            switch (reg)
+            {
+            case reg::ManufacturerId::addr:
+                value = MANUFACTURER_ID;
+                break;
+            case reg::DieId::addr:
+                value = DIE_ID;
+                break;
+            default:
+                if (reg >= sizeof(regs_) / sizeof(regs_[0]))
+                    return ESP_FAIL; // NACK
+                value = regs_[reg];
+                break;
+            }
+
+            if (reg == 0x06)
+            {
+                // Lecture de Mask/Enable : acquitte CVRF, le latch d'alerte et relâche ALERT
+                regs_[6] &= ~ME_CVRF;
+                if (regs_[6] & ME_LEN)
+                    regs_[6] &= ~ME_AFF;
+                alert_pin_ = false;
+            }
+            else if (reg >= 0x01 && reg <= 0x04)
+            {
+                read_mask_ |= 1 << reg;
+                if ((read_mask_ & RESULT_REGS_MASK) == RESULT_REGS_MASK)
+                    consumed_cv_.notify_all();
+            }
+        }
+
+        data[0] = value >> 8;
+        data[1] = value & 0xFF;
+        return ESP_OK;
+    }
+
+    esp_err_t ReplayBus::write(uint8_t reg, const uint8_t *data, size_t len)
+    {
+        if (len != 2)
+            return ESP_ERR_INVALID_SIZE;
+
+        const uint16_t value = (static_cast<uint16_t>(data[0]) << 8) | data[1];
+        std::lock_guard<std::mutex> lock(mutex_);
+        switch (reg)
+        {
+        case 0x00:
+            if (reg::Configuration::RST::test(value))
+            {
+                // Soft reset : tous les registres reprennent leur valeur par défaut
+                for (auto &r : regs_)
+                    r = 0;
+                regs_[0] = DEFAULT_CONFIG;
+            }
+            else
+            {
+                regs_[0] = value;
+                regs_[6] &= ~ME_CVRF;
+            }
+            alert_pin_ = false;
+            break;
+        case 0x05:
+            regs_[5] = reg::Calibration::CAL::get(value);
+            break;
+        case 0x06:
+            regs_[6] = (regs_[6] & ~ME_WRITABLE) | (value & ME_WRITABLE);
+            break;
+        case 0x07:
+            regs_[7] = value;
+            break;
+        default:
+            break; // registres en lecture seule : ignorés comme par le composant
+        }
+        return ESP_OK;
+    }
+
+    bool ReplayBus::fetch(RawSample &out)
+    {
+#if CONFIG_IDF_TARGET_LINUX
+        if (reader_)
+            return reader_->read(pos_, &out, 1) == 1;
+#endif
+        if (next_ >= count_)
+            return false;
+        out = samples_[next_++];
+        return true;
+    }
+
+    bool ReplayBus::evaluate_alert_function() const
+    {
+        // Comparaison directe registre / limite, comme le comparateur interne
+        const uint16_t me = regs_[6];
+        const uint16_t limit = regs_[7];
+        if (me & ME_SOL)
+            return current_.shunt > static_cast<int16_t>(limit);
+        if (me & ME_SUL)
+            return current_.shunt < static_cast<int16_t>(limit);
+        if (me & ME_BOL)
+            return current_.bus > limit;
+        if (me & ME_BUL)
+            return current_.bus < limit;
+        if (me & ME_POL)
+            return current_.power > limit;
+        return false;
+    }
+
+    bool ReplayBus::step()
+    {
+        RawSample sample;
+        if (!fetch(sample))
+            return false;
+        apply(sample);
+        return true;
+    }
+
+    void ReplayBus::apply(const RawSample &sample)
+    {
+        {
+            // L'échantillon est disponible : l'horloge le rejoint avant que le pilote ne le lise
+            std::lock_guard<std::mutex> lock(clock_mutex_);
+            clock_base_us_ = clock_limit_us_ = sample.timestamp_us;
+            clock_anchor_ = std::chrono::steady_clock::now();
+        }
+
+        EdgeCallback cb = nullptr;
+        void *ctx = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if ((read_mask_ & RESULT_REGS_MASK) != RESULT_REGS_MASK)
+                ++dropped_;
+
+            current_ = sample;
+            regs_[1] = static_cast<uint16_t>(sample.shunt);
+            regs_[2] = sample.bus;
+            regs_[3] = sample.power;
+            regs_[4] = static_cast<uint16_t>(sample.current);
+            read_mask_ = 0;
+            regs_[6] |= ME_CVRF;
+
+            if (evaluate_alert_function())
+                regs_[6] |= ME_AFF;
+            else if (!(regs_[6] & ME_LEN))
+                regs_[6] &= ~ME_AFF;
+
+            const bool active = ((regs_[6] & ME_CNVR) && (regs_[6] & ME_CVRF)) ||
+                                ((regs_[6] & ME_FUNCTIONS) && (regs_[6] & ME_AFF));
+            if (active && !alert_pin_)
+            {
+                ++edges_;
+                cb = edge_cb_;
+                ctx = edge_ctx_;
+            }
+            alert_pin_ = active;
+            ++replayed_;
+        }
+
+        if (cb)
+            cb(ctx);
+    }
+
+    void ReplayBus::run(float speed, bool lockstep, uint32_t timeout_ms)
+    {
+        using steady = std::chrono::steady_clock;
+        const auto start = steady::now();
+        int64_t first_us = INT64_MIN;
+
+        RawSample sample;
+        while (fetch(sample))
+        {
+            if (first_us == INT64_MIN)
+                first_us = sample.timestamp_us;
+
+            {
+                // Entre deux échantillons, le temps virtuel avance au rythme du rejeu
+                std::lock_guard<std::mutex> lock(clock_mutex_);
+                clock_limit_us_ = sample.timestamp_us > clock_base_us_ ? sample.timestamp_us : clock_base_us_;
+                clock_speed_ = speed > 0.0f ? speed : 0.0f;
+            }
+
+            if (speed > 0.0f)
+            {
+                auto due = start + std::chrono::microseconds(
+                                       static_cast<int64_t>((sample.timestamp_us - first_us) / speed));
+                std::this_thread::sleep_until(due);
+            }
+
+            if (lockstep)
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                consumed_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]
+                                      { return (read_mask_ & RESULT_REGS_MASK) == RESULT_REGS_MASK; });
+            }
+
+            apply(sample);
+        }
+        {
+            std::lock_guard<std::mutex> lock(clock_mutex_);
+            clock_speed_ = 0.0f;
+        }
+
+        ESP_LOGI(TAG, "Rejeu terminé : %u échantillons, %u fronts, %u perdus",
+                 static_cast<unsigned>(replayed_), static_cast<unsigned>(edges_), static_cast<unsigned>(dropped_));
+    }
+
+} // namespace ina226
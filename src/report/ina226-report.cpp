@@ -0,0 +1,91 @@
+#include "report/ina226-report.hpp"
+
+#include <cinttypes>
+
+#include "esp_log.h"
+
+#include "ina226-format.hpp"
+
+namespace ina226
+{
+    static const char *TAG = "INA226-REPORT";
+
+    const Deadband &ReportPolicy::channel(ReportChannel c) const
+    {
+        switch (c)
+        {
+        case ReportChannel::Shunt:
+            return shunt_uv;
+        case ReportChannel::Bus:
+            return bus_mv;
+        case ReportChannel::Current:
+            return current_ma;
+        default:
+            return power_mw;
+        }
+    }
+
+    bool ReportFilter::accept(const Measurement &m)
+    {
+        ++stats_.evaluated;
+        if (!has_reference_)
+        {
+            reference_ = m;
+            has_reference_ = true;
+            ++stats_.reported;
+            return true;
+        }
+
+        const float ref[] = {reference_.shunt_uv, reference_.bus_mv, reference_.current_ma, reference_.power_mw};
+        const float val[] = {m.shunt_uv, m.bus_mv, m.current_ma, m.power_mw};
+        bool moved = false;
+        for (size_t i = 0; i < static_cast<size_t>(ReportChannel::Count); ++i)
+        {
+            if (policy_.channel(static_cast<ReportChannel>(i)).exceeded(ref[i], val[i]))
+            {
+                ++stats_.triggers[i];
+                moved = true;
+            }
+        }
+
+        const bool silent_too_long =
+            policy_.max_silence_ms &&
+            m.timestamp_us - reference_.timestamp_us >= static_cast<int64_t>(policy_.max_silence_ms) * 1000;
+        if (!moved && !silent_too_long)
+        {
+            ++stats_.suppressed;
+            return false;
+        }
+        if (!moved)
+            ++stats_.heartbeats;
+        ++stats_.reported;
+        reference_ = m;
+        return true;
+    }
+
+    void ReportStats::log() const
+    {
+        ESP_LOGI(TAG, "Évalués %" PRIu32 ", émis %" PRIu32 " (%.2f %%), supprimés %" PRIu32 ", battements %" PRIu32,
+                 evaluated, reported, ratio() * 100.0f, suppressed, heartbeats);
+        ESP_LOGI(TAG, "Déclenchements : shunt %" PRIu32 ", bus %" PRIu32 ", courant %" PRIu32 ", puissance %" PRIu32,
+                 triggers[0], triggers[1], triggers[2], triggers[3]);
+    }
+
+    size_t ReportStats::to_json(char *buf, size_t len) const
+    {
+        return format_to(buf, len,
+                         "{\"evaluated\": %" PRIu32 ",\"reported\": %" PRIu32 ",\"suppressed\": %" PRIu32
+                         ",\"heartbeats\": %" PRIu32 ",\"ratio\": %.5f,\"triggers\": {\"shunt\": %" PRIu32
+                         ",\"bus\": %" PRIu32 ",\"current\": %" PRIu32 ",\"power\": %" PRIu32 "}}",
+                         evaluated, reported, suppressed, heartbeats, ratio(), triggers[0], triggers[1],
+                         triggers[2], triggers[3]);
+    }
+
+    std::string ReportStats::to_json() const
+    {
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
+    }
+
+} // namespace ina226
@@ -0,0 +1,236 @@
+#include "ripple/ina226-ripple.hpp"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstring>
+
+#include "esp_log.h"
+
+#include "ina226-format.hpp"
+
+namespace ina226
+{
+    static const char *TAG = "INA226-RIPPLE";
+
+    /// LSB du registre 0x02 en mV
+    static constexpr float BUS_LSB_MV = reg::BusVoltage::lsb * 1e-6f;
+
+    static constexpr RippleBand DEFAULT_BANDS[] = {
+        {0.0f, 150.0f},    // secteur redressé 50/60 Hz et harmoniques basses
+        {150.0f, 1000.0f}, // oscillations de régulation
+        {1000.0f, 0.0f},   // jusqu'à Nyquist
+    };
+
+    void RippleReport::log() const
+    {
+        ESP_LOGI(TAG, "%u échantillons à %.1f Hz (résolution %.2f Hz, %" PRIu32 " manques)",
+                 static_cast<unsigned>(samples), sample_rate_hz, resolution_hz, gaps);
+        ESP_LOGI(TAG, "Moyenne %.2f mV, ondulation %.2f mV crête-crête, %.3f mV eff.", mean_mv, peak_to_peak_mv,
+                 rms_mv);
+        for (size_t i = 0; i < peak_count; ++i)
+            ESP_LOGI(TAG, "Raie %u : %.1f Hz, %.3f mV crête", static_cast<unsigned>(i + 1), peaks[i].frequency_hz,
+                     peaks[i].amplitude_mv);
+        for (size_t i = 0; i < band_count; ++i)
+            ESP_LOGI(TAG, "Bande %.0f–%.0f Hz : %.3f mV eff.", bands[i].range.low_hz, bands[i].range.high_hz,
+                     bands[i].rms_mv);
+    }
+
+    size_t RippleReport::to_json(char *buf, size_t len) const
+    {
+        size_t n = format_to(buf, len,
+                             "{\"samples\": %u,\"sample_rate_hz\": %.2f,\"resolution_hz\": %.3f,\"gaps\": %" PRIu32
+                             ",\"mean_mv\": %.3f,\"peak_to_peak_mv\": %.3f,\"rms_mv\": %.4f,\"peaks\": [",
+                             static_cast<unsigned>(samples), sample_rate_hz, resolution_hz, gaps, mean_mv,
+                             peak_to_peak_mv, rms_mv);
+        for (size_t i = 0; i < peak_count; ++i)
+            n += format_to(buf + n, len - n, "%s{\"frequency_hz\": %.2f,\"amplitude_mv\": %.4f}", i ? "," : "",
+                           peaks[i].frequency_hz, peaks[i].amplitude_mv);
+        n += format_to(buf + n, len - n, "],\"bands\": [");
+        for (size_t i = 0; i < band_count; ++i)
+            n += format_to(buf + n, len - n, "%s{\"low_hz\": %.1f,\"high_hz\": %.1f,\"rms_mv\": %.4f}", i ? "," : "",
+                           bands[i].range.low_hz, bands[i].range.high_hz, bands[i].rms_mv);
+        n += format_to(buf + n, len - n, "]}");
+        return n;
+    }
+
+    std::string RippleReport::to_json() const
+    {
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
+    }
+
+    RippleAnalyzer::RippleAnalyzer()
+    {
+        const int16_t *w = fft_.window();
+        for (size_t i = 0; i < N; ++i)
+        {
+            const float v = w[i] / 32768.0f;
+            window_power_ += v * v;
+        }
+        set_bands(DEFAULT_BANDS, sizeof(DEFAULT_BANDS) / sizeof(DEFAULT_BANDS[0]));
+    }
+
+    void RippleAnalyzer::set_bands(const RippleBand *bands, size_t count)
+    {
+        band_count_ = count < RippleReport::MAX_BANDS ? count : RippleReport::MAX_BANDS;
+        for (size_t i = 0; i < band_count_; ++i)
+            bands_[i] = bands[i];
+    }
+
+    esp_err_t RippleAnalyzer::analyze(const uint16_t *bus_raw, size_t count, float sample_rate_hz, RippleReport &out)
+    {
+        if (!bus_raw || count != N)
+            return ESP_ERR_INVALID_SIZE;
+        std::memcpy(raw_, bus_raw, sizeof(raw_));
+        const esp_err_t err = analyze_buffer(sample_rate_hz, out);
+        out.gaps = 0;
+        return err;
+    }
+
+    float RippleAnalyzer::bin_amplitude(size_t k) const
+    {
+        // Énergie du lobe principal de Hann (± 2 raies) : indépendante de la position de
+        // la fréquence entre deux raies, contrairement au module de la raie seule
+        const size_t lo = k > 2 ? k - 2 : 1;
+        const size_t hi = k + 2 < N / 2 ? k + 2 : N / 2 - 1;
+        float energy = 0.0f;
+        for (size_t i = lo; i <= hi; ++i)
+            energy += power_[i];
+        // Σ|X|² d'une demi-bande = N·Σw²·A²/4
+        return 2.0f * std::sqrt(energy / (N * window_power_));
+    }
+
+    esp_err_t RippleAnalyzer::analyze_buffer(float sample_rate_hz, RippleReport &out)
+    {
+        out = RippleReport{};
+        if (!(sample_rate_hz > 0.0f))
+            return ESP_ERR_INVALID_ARG;
+
+        out.samples = N;
+        out.sample_rate_hz = sample_rate_hz;
+        out.resolution_hz = sample_rate_hz / N;
+
+        // Domaine temporel, en entiers
+        int64_t sum = 0;
+        uint16_t lo = UINT16_MAX, hi = 0;
+        for (size_t i = 0; i < N; ++i)
+        {
+            sum += raw_[i];
+            lo = raw_[i] < lo ? raw_[i] : lo;
+            hi = raw_[i] > hi ? raw_[i] : hi;
+        }
+        const int32_t mean = static_cast<int32_t>((sum + static_cast<int64_t>(N / 2)) / static_cast<int64_t>(N));
+        int64_t dev_sum = 0, dev_sq = 0;
+        int32_t dev_max = 0;
+        for (size_t i = 0; i < N; ++i)
+        {
+            const int32_t d = raw_[i] - mean;
+            dev_sum += d;
+            dev_sq += static_cast<int64_t>(d) * d;
+            const int32_t a = d < 0 ? -d : d;
+            dev_max = a > dev_max ? a : dev_max;
+        }
+        const double dev_mean = static_cast<double>(dev_sum) / N;
+        out.mean_mv = static_cast<float>((mean + dev_mean) * BUS_LSB_MV);
+        out.peak_to_peak_mv = (hi - lo) * BUS_LSB_MV;
+        out.rms_mv = static_cast<float>(std::sqrt(std::fmax(0.0, static_cast<double>(dev_sq) / N - dev_mean * dev_mean)) *
+                                        BUS_LSB_MV);
+
+        out.band_count = band_count_;
+        const float nyquist = sample_rate_hz / 2.0f;
+        for (size_t b = 0; b < band_count_; ++b)
+        {
+            out.bands[b].range = bands_[b];
+            if (!(bands_[b].high_hz > 0.0f) || bands_[b].high_hz > nyquist)
+                out.bands[b].range.high_hz = nyquist;
+        }
+        if (dev_max == 0)
+            return ESP_OK; // tension parfaitement continue : spectre nul
+
+        // Normalisation à pleine échelle d'étage : l'ondulation de quelques LSB garde toute
+        // la précision Q15 au lieu d'être noyée par la composante continue
+        int shift = 0;
+        while (shift < 15 && (dev_max << (shift + 1)) <= Fft::STAGE_LIMIT)
+            ++shift;
+        while (shift <= 0 && (dev_max >> -shift) > Fft::STAGE_LIMIT)
+            --shift;
+
+        const int16_t *w = fft_.window();
+        for (size_t i = 0; i < N; ++i)
+        {
+            const int32_t d = raw_[i] - mean;
+            const int32_t scaled = shift >= 0 ? d * (1 << shift) : d >> -shift;
+            re_[i] = static_cast<int16_t>((scaled * w[i] + (1 << 14)) >> 15);
+            im_[i] = 0;
+        }
+        const int exponent = fft_.forward(re_, im_) - shift;
+
+        // Spectre de puissance, en LSB² ; signal réel : la moitié positive suffit
+        const float scale = std::ldexp(1.0f, 2 * exponent);
+        for (size_t k = 0; k < N / 2; ++k)
+        {
+            const int32_t r = re_[k];
+            const int32_t m = im_[k];
+            power_[k] = static_cast<float>(r * r + m * m) * scale;
+        }
+        power_[0] = 0.0f; // résidu de la moyenne entière
+
+        // Raies dominantes : maxima locaux hors continu, les plus forts d'abord
+        size_t top[RippleReport::MAX_PEAKS];
+        size_t found = 0;
+        for (size_t k = 2; k + 1 < N / 2; ++k)
+        {
+            if (!(power_[k] > power_[k - 1] && power_[k] >= power_[k + 1]))
+                continue;
+            size_t pos = found < RippleReport::MAX_PEAKS ? found++ : RippleReport::MAX_PEAKS;
+            while (pos > 0 && power_[top[pos - 1]] < power_[k])
+            {
+                if (pos < RippleReport::MAX_PEAKS)
+                    top[pos] = top[pos - 1];
+                --pos;
+            }
+            if (pos < RippleReport::MAX_PEAKS)
+                top[pos] = k;
+        }
+        out.peak_count = found;
+        for (size_t i = 0; i < found; ++i)
+        {
+            const size_t k = top[i];
+            // Interpolation parabolique sur les modules : fréquence entre deux raies
+            const float a = std::sqrt(power_[k - 1]);
+            const float b = std::sqrt(power_[k]);
+            const float c = std::sqrt(power_[k + 1]);
+            const float den = a - 2.0f * b + c;
+            const float delta = den < 0.0f ? 0.5f * (a - c) / den : 0.0f;
+            out.peaks[i].frequency_hz = (k + delta) * out.resolution_hz;
+            out.peaks[i].amplitude_mv = bin_amplitude(k) * BUS_LSB_MV;
+        }
+        // L'amplitude intègre tout le lobe : l'ordre peut différer de celui des raies centrales
+        for (size_t i = 1; i < found; ++i)
+        {
+            const RippleReport::Peak p = out.peaks[i];
+            size_t j = i;
+            for (; j > 0 && out.peaks[j - 1].amplitude_mv < p.amplitude_mv; --j)
+                out.peaks[j] = out.peaks[j - 1];
+            out.peaks[j] = p;
+        }
+
+        // Valeur efficace par bande : Parseval sur la demi-bande, fenêtre compensée
+        const float band_norm = 2.0f / (N * window_power_);
+        for (size_t b = 0; b < band_count_; ++b)
+        {
+            const RippleBand &range = out.bands[b].range;
+            float energy = 0.0f;
+            for (size_t k = 1; k < N / 2; ++k)
+            {
+                const float f = k * out.resolution_hz;
+                if (f >= range.low_hz && f < range.high_hz)
+                    energy += power_[k];
+            }
+            out.bands[b].rms_mv = std::sqrt(energy * band_norm) * BUS_LSB_MV;
+        }
+        return ESP_OK;
+    }
+
+} // namespace ina226
@@ -1,5 +1,5 @@
 #include "status/ina226-status_types.hpp"
-#include <sstream>
+#include "ina226-format.hpp"
 
 namespace ina226
 {
@@ -7,14 +7,15 @@ namespace ina226
 
     void StatusRegister::decode(uint16_t reg)
     {
+        using R = reg::MaskEnable;
         raw_value = reg;
-        shunt_over_limit = reg & (1 << 15);
-        shunt_under_limit = reg & (1 << 14);
-        bus_over_limit = reg & (1 << 13);
-        bus_under_limit = reg & (1 << 12);
-        power_over_limit = reg & (1 << 11);
-        conversion_ready = reg & (1 << 10);
-        alert_flag = reg & (1 << 9);
+        shunt_over_limit = R::SOL::test(reg);
+        shunt_under_limit = R::SUL::test(reg);
+        bus_over_limit = R::BOL::test(reg);
+        bus_under_limit = R::BUL::test(reg);
+        power_over_limit = R::POL::test(reg);
+        conversion_ready = R::CNVR::test(reg);
+        alert_flag = R::AFF::test(reg);
     }
 
     void StatusRegister::log() const
@@ -24,16 +25,21 @@ namespace ina226
                  bus_over_limit, bus_under_limit, shunt_over_limit, shunt_under_limit);
     }
 
+    size_t StatusRegister::to_json(char *buf, size_t len) const
+    {
+        return format_to(buf, len,
+                         "{\"shunt_over_limit\": %s,\"shunt_under_limit\": %s,\"bus_over_limit\": %s,"
+                         "\"bus_under_limit\": %s,\"power_over_limit\": %s,\"conversion_ready\": %s,"
+                         "\"alert_flag\": %s}",
+                         bool_str(shunt_over_limit), bool_str(shunt_under_limit), bool_str(bus_over_limit),
+                         bool_str(bus_under_limit), bool_str(power_over_limit), bool_str(conversion_ready),
+                         bool_str(alert_flag));
+    }
+
     std::string StatusRegister::to_json() const
     {
-        return std::string("{") +
-               "\"shunt_over_limit\": " + (shunt_over_limit ? "true" : "false") + "," +
-               "\"shunt_under_limit\": " + (shunt_under_limit ? "true" : "false") + "," +
-               "\"bus_over_limit\": " + (bus_over_limit ? "true" : "false") + "," +
-               "\"bus_under_limit\": " + (bus_under_limit ? "true" : "false") + "," +
-               "\"power_over_limit\": " + (power_over_limit ? "true" : "false") + "," +
-               "\"conversion_ready\": " + (conversion_ready ? "true" : "false") + "," +
-               "\"alert_flag\": " + (alert_flag ? "true" : "false") +
-               "}";
+        char buf[JSON_SIZE];
+        to_json(buf, sizeof(buf));
+        return buf;
     }
 }
@@ -0,0 +1,105 @@
+#include "sync/ina226-sync.hpp"
+
+#include <cinttypes>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "ina226-error.hpp"
+
+namespace ina226
+{
+    esp_err_t SyncGroup::add(Config &cfg, CTRL &ctrl)
+    {
+        if (count_ >= SyncSample::MAX_DEVICES)
+            return ESP_ERR_NO_MEM;
+        devices_[count_++] = {&cfg, &ctrl};
+        return ESP_OK;
+    }
+
+    esp_err_t SyncGroup::prepare()
+    {
+        period_us_ = 0;
+        for (size_t i = 0; i < count_; ++i)
+        {
+            ConfigurationRegister &reg = devices_[i].cfg->datas().configuration;
+            RETURN_IF_ERROR(devices_[i].cfg->get_config());
+            ConfigurationRegister::ConfigurationReg values = reg.get_values();
+            values.mode = ConfigurationRegister::OperatingMode::ShuntAndBusTriggered;
+            reg.set_values(values);
+
+            // On attend le composant le plus lent
+            const uint32_t period = reg.conversion_period_us();
+            if (period > period_us_)
+                period_us_ = period;
+        }
+        return ESP_OK;
+    }
+
+    esp_err_t SyncGroup::wait_ready(Device &dev, int64_t deadline_us)
+    {
+        while (true)
+        {
+            // Lecture dans une variable locale : l'image du masque dans cfg reste celle de l'utilisateur
+            uint16_t mask = 0;
+            RETURN_IF_ERROR(dev.cfg->read<reg::MaskEnable>(mask));
+            if (reg::MaskEnable::CVRF::test(mask))
+                return ESP_OK;
+            if (esp_timer_get_time() > deadline_us)
+                return ESP_ERR_TIMEOUT;
+            // Conversion pas encore terminée : on rend la main un tick entre deux lectures
+            vTaskDelay(1);
+        }
+    }
+
+    esp_err_t SyncGroup::acquire(SyncSample &out, uint32_t timeout_ms)
+    {
+        if (count_ == 0)
+            return ESP_ERR_INVALID_STATE;
+
+        // Écritures de déclenchement dos à dos : rien d'autre entre deux transactions
+        for (size_t i = 0; i < count_; ++i)
+        {
+            esp_err_t err = devices_[i].cfg->set_config();
+            out.trigger_us[i] = esp_timer_get_time();
+            if (err != ESP_OK)
+                return err;
+        }
+        out.count = count_;
+        out.skew_us = out.trigger_us[count_ - 1] - out.trigger_us[0];
+        skew_.add(out.skew_us);
+
+        // Le premier résultat ne peut pas arriver avant une période de conversion
+        const uint32_t wait_ms = period_us_ / 1000;
+        if (wait_ms >= portTICK_PERIOD_MS)
+            vTaskDelay(pdMS_TO_TICKS(wait_ms));
+
+        const int64_t deadline = out.trigger_us[count_ - 1] + period_us_ + static_cast<int64_t>(timeout_ms) * 1000;
+        for (size_t i = 0; i < count_; ++i)
+        {
+            esp_err_t err = wait_ready(devices_[i], deadline);
+            if (err == ESP_ERR_TIMEOUT)
+            {
+                ++timeouts_;
+                ESP_LOGW(TAG, "Composant %u : pas de CVRF après %u ms", static_cast<unsigned>(i),
+                         static_cast<unsigned>(timeout_ms));
+            }
+            RETURN_IF_ERROR(err);
+            RETURN_IF_ERROR(devices_[i].ctrl->get_raw(out.raw[i]));
+            out.raw[i].timestamp_us = out.trigger_us[i];
+        }
+        return ESP_OK;
+    }
+
+    void SyncGroup::log() const
+    {
+        ESP_LOGI(TAG, "%u composants, période %u µs", static_cast<unsigned>(count_), static_cast<unsigned>(period_us_));
+        ESP_LOGI(TAG, "Écart de déclenchement : moyenne %" PRId64 " µs, max %" PRId64 " µs, gigue %" PRId64
+                      " µs (n=%u), timeouts %u",
+                 skew_.mean_us(), skew_.max_us, skew_.jitter_us(), static_cast<unsigned>(skew_.count),
+                 static_cast<unsigned>(timeouts_));
+    }
+
+} // namespace ina226
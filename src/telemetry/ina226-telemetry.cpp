@@ -0,0 +1,303 @@
+#include "telemetry/ina226-telemetry.hpp"
+#include "ina226-clock.hpp"
+#include "ina226-format.hpp"
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sdkconfig.h"
+#include "esp_log.h"
+
+#if !CONFIG_IDF_TARGET_LINUX
+#include "driver/uart.h"
+#endif
+
+namespace ina226
+{
+    static const char *TAG = "INA226-TELEMETRY";
+
+    TelemetrySummary TelemetrySummary::from(const Measurement *samples, size_t count)
+    {
+        TelemetrySummary s;
+        if (count == 0)
+            return s;
+
+        s.first_us = samples[0].timestamp_us;
+        s.last_us = samples[count - 1].timestamp_us;
+        s.count = static_cast<uint32_t>(count);
+        s.current_min_ma = samples[0].current_ma;
+        s.current_max_ma = samples[0].current_ma;
+
+        double current = 0.0, bus = 0.0, power = 0.0, energy_uj = 0.0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Measurement &m = samples[i];
+            if (m.current_ma < s.current_min_ma)
+                s.current_min_ma = m.current_ma;
+            if (m.current_ma > s.current_max_ma)
+                s.current_max_ma = m.current_ma;
+            current += m.current_ma;
+            bus += m.bus_mv;
+            power += m.power_mw;
+            if (i > 0) // mW × µs = nJ
+                energy_uj += 0.5 * (m.power_mw + samples[i - 1].power_mw) *
+                             static_cast<double>(m.timestamp_us - samples[i - 1].timestamp_us) / 1000.0;
+        }
+        s.current_mean_ma = static_cast<float>(current / count);
+        s.bus_mean_mv = static_cast<float>(bus / count);
+        s.power_mean_mw = static_cast<float>(power / count);
+        s.energy_mj = static_cast<float>(energy_uj / 1000.0);
+        return s;
+    }
+
+    // === TelemetrySink ===
+
+    TelemetrySink::TelemetrySink(char *buffer, size_t capacity, TelemetryFormat format, FlushPolicy policy)
+        : buf_(buffer),
+          capacity_(capacity),
+          format_(format),
+          policy_(policy)
+    {
+    }
+
+    size_t TelemetrySink::format_sample(char *out, size_t len, const Measurement &m) const
+    {
+        if (format_ == TelemetryFormat::Csv)
+            return format_to(out, len, "%" PRId64 ",%.1f,%.1f,%.2f,%.1f\n",
+                             m.timestamp_us, m.shunt_uv, m.bus_mv, m.current_ma, m.power_mw);
+        return format_to(out, len,
+                         "{\"t_us\": %" PRId64 ",\"shunt_uv\": %.1f,\"bus_mv\": %.1f,\"current_ma\": %.2f,\"power_mw\": %.1f}\n",
+                         m.timestamp_us, m.shunt_uv, m.bus_mv, m.current_ma, m.power_mw);
+    }
+
+    esp_err_t TelemetrySink::append(const char *record, size_t len, bool is_sample)
+    {
+        esp_err_t err = ESP_OK;
+        if (used_ + len > capacity_)
+            err = flush();
+        if (len > capacity_)
+        {
+            ++stats_.dropped;
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        if (pending_ == 0)
+            oldest_us_ = clock::now_us();
+        memcpy(buf_ + used_, record, len);
+        used_ += len;
+        ++pending_;
+        if (is_sample)
+        {
+            ++pending_samples_;
+            ++stats_.samples;
+        }
+        else
+        {
+            ++stats_.summaries;
+        }
+
+        if (pending_samples_ >= policy_.max_samples)
+        {
+            esp_err_t ferr = flush();
+            if (err == ESP_OK)
+                err = ferr;
+        }
+        return err;
+    }
+
+    esp_err_t TelemetrySink::push(const Measurement &sample)
+    {
+        char record[RECORD_SIZE];
+        const size_t len = format_sample(record, sizeof(record), sample);
+        return append(record, len, true);
+    }
+
+    esp_err_t TelemetrySink::push(const Measurement *samples, size_t count)
+    {
+        esp_err_t err = ESP_OK;
+        for (size_t i = 0; i < count; ++i)
+        {
+            esp_err_t e = push(samples[i]);
+            if (err == ESP_OK)
+                err = e;
+        }
+        return err;
+    }
+
+    esp_err_t TelemetrySink::push(const TelemetrySummary &s)
+    {
+        char record[RECORD_SIZE];
+        size_t len;
+        if (format_ == TelemetryFormat::Csv)
+            len = format_to(record, sizeof(record),
+                            "#summary,%" PRId64 ",%" PRId64 ",%" PRIu32 ",%.2f,%.2f,%.2f,%.1f,%.1f,%.3f\n",
+                            s.first_us, s.last_us, s.count, s.current_min_ma, s.current_max_ma,
+                            s.current_mean_ma, s.bus_mean_mv, s.power_mean_mw, s.energy_mj);
+        else
+            len = format_to(record, sizeof(record),
+                            "{\"summary\": {\"first_us\": %" PRId64 ",\"last_us\": %" PRId64 ",\"count\": %" PRIu32
+                            ",\"current_min_ma\": %.2f,\"current_max_ma\": %.2f,\"current_mean_ma\": %.2f"
+                            ",\"bus_mean_mv\": %.1f,\"power_mean_mw\": %.1f,\"energy_mj\": %.3f}}\n",
+                            s.first_us, s.last_us, s.count, s.current_min_ma, s.current_max_ma,
+                            s.current_mean_ma, s.bus_mean_mv, s.power_mean_mw, s.energy_mj);
+        return append(record, len, false);
+    }
+
+    esp_err_t TelemetrySink::poll()
+    {
+        if (pending_ == 0)
+            return ESP_OK;
+        if (clock::now_us() - oldest_us_ < static_cast<int64_t>(policy_.max_age_ms) * 1000)
+            return ESP_OK;
+        return flush();
+    }
+
+    esp_err_t TelemetrySink::flush()
+    {
+        if (used_ == 0)
+            return ESP_OK;
+
+        esp_err_t err = write(buf_, used_);
+        ++stats_.batches;
+        if (err == ESP_OK)
+        {
+            stats_.bytes += used_;
+        }
+        else
+        {
+            // Lot abandonné : on ne bloque pas la chaîne d'acquisition sur une sortie en panne
+            ++stats_.write_errors;
+            stats_.dropped += pending_;
+        }
+        used_ = 0;
+        pending_ = 0;
+        pending_samples_ = 0;
+        return err;
+    }
+
+    // === UartSink ===
+
+    UartSink::UartSink(char *buffer, size_t capacity, int uart_port, TelemetryFormat format, FlushPolicy policy)
+        : TelemetrySink(buffer, capacity, format, policy),
+          uart_port_(uart_port)
+    {
+    }
+
+    esp_err_t UartSink::write(const char *data, size_t len)
+    {
+#if !CONFIG_IDF_TARGET_LINUX
+        if (uart_port_ >= 0)
+        {
+            const int n = uart_write_bytes(static_cast<uart_port_t>(uart_port_), data, len);
+            return n == static_cast<int>(len) ? ESP_OK : ESP_FAIL;
+        }
+#endif
+        if (fwrite(data, 1, len, stdout) != len)
+            return ESP_FAIL;
+        fflush(stdout);
+        return ESP_OK;
+    }
+
+    // === FileSink ===
+
+    FileSink::FileSink(char *buffer, size_t capacity, TelemetryFormat format, FlushPolicy policy)
+        : TelemetrySink(buffer, capacity, format, policy)
+    {
+    }
+
+    FileSink::~FileSink()
+    {
+        close();
+    }
+
+    esp_err_t FileSink::open(const char *path, bool append)
+    {
+        close();
+        file_ = fopen(path, append ? "a" : "w");
+        if (!file_)
+        {
+            ESP_LOGE(TAG, "Ouverture de %s impossible", path);
+            return ESP_FAIL;
+        }
+        return ESP_OK;
+    }
+
+    esp_err_t FileSink::close()
+    {
+        if (!file_)
+            return ESP_OK;
+        esp_err_t err = flush();
+        fclose(file_);
+        file_ = nullptr;
+        return err;
+    }
+
+    esp_err_t FileSink::write(const char *data, size_t len)
+    {
+        if (!file_)
+            return ESP_ERR_INVALID_STATE;
+        if (fwrite(data, 1, len, file_) != len)
+            return ESP_FAIL;
+        return fflush(file_) == 0 ? ESP_OK : ESP_FAIL;
+    }
+
+    // === SocketSink ===
+
+    SocketSink::SocketSink(char *buffer, size_t capacity, TelemetryFormat format, FlushPolicy policy)
+        : TelemetrySink(buffer, capacity, format, policy)
+    {
+    }
+
+    SocketSink::~SocketSink()
+    {
+        close();
+    }
+
+    esp_err_t SocketSink::open(uint16_t port, const char *ipv4)
+    {
+        close();
+        in_addr addr;
+        if (inet_pton(AF_INET, ipv4, &addr) != 1)
+            return ESP_ERR_INVALID_ARG;
+
+        fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd_ < 0)
+        {
+            ESP_LOGE(TAG, "socket() : errno %d", errno);
+            return ESP_FAIL;
+        }
+        addr_ = addr.s_addr;
+        port_ = port;
+        return ESP_OK;
+    }
+
+    esp_err_t SocketSink::close()
+    {
+        if (fd_ < 0)
+            return ESP_OK;
+        esp_err_t err = flush();
+        ::close(fd_);
+        fd_ = -1;
+        return err;
+    }
+
+    esp_err_t SocketSink::write(const char *data, size_t len)
+    {
+        if (fd_ < 0)
+            return ESP_ERR_INVALID_STATE;
+
+        sockaddr_in dest = {};
+        dest.sin_family = AF_INET;
+        dest.sin_port = htons(port_);
+        dest.sin_addr.s_addr = addr_;
+        const ssize_t n = sendto(fd_, data, len, 0, reinterpret_cast<const sockaddr *>(&dest), sizeof(dest));
+        return n == static_cast<ssize_t>(len) ? ESP_OK : ESP_FAIL;
+    }
+
+} // namespace ina226
@@ -0,0 +1,88 @@
+#include "transient/ina226-transient.hpp"
+
+#include <algorithm>
+
+namespace ina226
+{
+    TransientCapture::TransientCapture(Measurement *storage, size_t capacity, size_t pre_samples, size_t post_samples)
+        : buf_(storage),
+          pre_(pre_samples),
+          post_(post_samples)
+    {
+        // Une mémoire trop petite réduit d'abord la fenêtre post-déclenchement
+        if (pre_ + post_ > capacity)
+        {
+            pre_ = std::min(pre_, capacity);
+            post_ = capacity - pre_;
+        }
+        size_ = pre_ + post_;
+    }
+
+    void TransientCapture::push(const Measurement &sample)
+    {
+        const State st = state_.load(std::memory_order_acquire);
+        if (st == State::Complete || size_ == 0)
+            return;
+
+        if (st == State::Armed)
+        {
+            // Historique pré-déclenchement : anneau limité aux pre_ premières cases
+            if (pre_ == 0)
+                return;
+            buf_[head_] = sample;
+            head_ = (head_ + 1) % pre_;
+            if (filled_ < pre_)
+                ++filled_;
+            return;
+        }
+
+        // Déclenchée : la fenêtre post-déclenchement suit l'historique figé
+        buf_[pre_ + post_seen_] = sample;
+        if (++post_seen_ >= post_)
+            finish();
+    }
+
+    bool TransientCapture::trigger(TriggerSource source, uint16_t mask_enable)
+    {
+        if (state_.load(std::memory_order_relaxed) != State::Armed)
+            return false;
+
+        // Le dernier échantillon poussé est celui du déclenchement
+        trigger_us_ = filled_ ? buf_[(head_ + pre_ - 1) % pre_].timestamp_us : 0;
+        record_.source = source;
+        record_.mask_enable = mask_enable;
+        post_seen_ = 0;
+        state_.store(State::Triggered, std::memory_order_relaxed);
+        if (post_ == 0)
+            finish();
+        return true;
+    }
+
+    void TransientCapture::finish()
+    {
+        // Remise à plat de l'anneau : le plus ancien échantillon en tête
+        if (filled_ == pre_ && head_ != 0)
+            std::rotate(buf_, buf_ + head_, buf_ + pre_);
+
+        // Historique incomplet : on rapproche la fenêtre post de l'historique réel
+        if (filled_ < pre_)
+            std::copy(buf_ + pre_, buf_ + pre_ + post_seen_, buf_ + filled_);
+
+        record_.trigger_us = trigger_us_;
+        record_.pre_count = filled_;
+        record_.post_count = post_seen_;
+        record_.samples = buf_;
+        ++captures_;
+        state_.store(State::Complete, std::memory_order_release);
+    }
+
+    void TransientCapture::rearm()
+    {
+        head_ = 0;
+        filled_ = 0;
+        post_seen_ = 0;
+        record_ = {};
+        state_.store(State::Armed, std::memory_order_release);
+    }
+
+} // namespace ina226